@@ -0,0 +1,278 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/stat.h>
+#ifdef _WINDOWS
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+#include "stb_image.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "AssetPack.h"
+
+const char PACK_MAGIC[4] = { 'L', 'L', 'A', 'P' };
+
+// purpose: map a whole file read-only, NULL if it can't be
+const unsigned char* map_file(const char* filepath, size_t& size)
+{
+#ifdef _WINDOWS
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    size = (size_t) file_size.QuadPart;
+
+    HANDLE mapping = size > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(file);
+    if (mapping == NULL) return NULL;
+
+    // the view keeps the mapping alive on its own
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    return (const unsigned char*) data;
+#else
+    int file = ::open(filepath, O_RDONLY);
+    if (file < 0) return NULL;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        ::close(file);
+        return NULL;
+    }
+    size = (size_t) status.st_size;
+
+    // the mapping keeps the file alive on its own
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    return data == MAP_FAILED ? NULL : (const unsigned char*) data;
+#endif
+}
+
+// purpose: what a baked image's source is checked by. false if it isn't there
+bool stat_source(const char* filepath, uint64_t& size, int64_t& modified)
+{
+    struct stat status;
+    if (stat(filepath, &status) != 0) return false;
+
+    size     = (uint64_t) status.st_size;
+    modified = (int64_t) status.st_mtime;
+    return true;
+}
+
+void unmap_file(const unsigned char* data, size_t size)
+{
+#ifdef _WINDOWS
+    UnmapViewOfFile(data);
+#else
+    munmap((void*) data, size);
+#endif
+}
+
+bool AssetPack::open(const char* filepath)
+{
+    close();
+
+    m_data = map_file(filepath, m_size);
+    if (m_data == NULL) return false;
+
+    // everything the header points at has to be inside the file
+    m_header = (const Header*) m_data;
+    bool valid = m_size >= sizeof(Header) &&
+                 memcmp(m_header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 && m_header->version == VERSION;
+
+    size_t tables = 0;
+    if (valid) {
+        tables = sizeof(Header) + (size_t) m_header->page_count * sizeof(PageEntry)
+                                + (size_t) m_header->image_count * sizeof(ImageEntry)
+                                + (size_t) m_header->delay_count * sizeof(float);
+        valid = tables <= m_size;
+    }
+
+    if (valid) {
+        m_pages  = (const PageEntry*) (m_data + sizeof(Header));
+        m_images = (const ImageEntry*) (m_pages + m_header->page_count);
+        m_delays = (const float*) (m_images + m_header->image_count);
+
+        for (int i = 0; valid && i < (int) m_header->page_count; i++) {
+            PageEntry const& page = m_pages[i];
+            // and no more mip levels than there are halvings of it
+            valid = page.format < FORMAT_COUNT && page.mip_levels <= m_header->mip_levels && page.mip_levels < 32 &&
+                    (std::max(page.width, page.height) >> page.mip_levels) > 0 && page.offset >= tables;
+            if (valid) {
+                uint64_t bytes = TextureAtlas::get_encoded_size((int) page.width, (int) page.height,
+                                                                (TextureFormat) page.format, (int) page.mip_levels);
+                valid = page.offset + bytes <= m_size;
+            }
+        }
+        // animate() would never get past a frame that shows for no time at all
+        for (int i = 0; valid && i < (int) m_header->delay_count; i++) {
+            valid = std::isfinite(m_delays[i]) && m_delays[i] > 0.0f;
+        }
+        for (int i = 0; valid && i < (int) m_header->image_count; i++) {
+            ImageEntry const& image = m_images[i];
+            valid = image.page < m_header->page_count && memchr(image.name, '\0', NAME_LENGTH) != NULL &&
+                    image.frame_count > 0 && image.frame_count <= image.columns * image.rows &&
+                    (image.frame_count == 1 || (uint64_t) image.first_delay + image.frame_count <= m_header->delay_count) &&
+                    image.frame_rect[0] >= 0.0f && image.frame_rect[0] < image.frame_rect[2] && image.frame_rect[2] <= 1.0f &&
+                    image.frame_rect[1] >= 0.0f && image.frame_rect[1] < image.frame_rect[3] && image.frame_rect[3] <= 1.0f;
+        }
+    }
+
+    if (!valid) {
+        std::printf("Ignoring asset pack %s, it's damaged or out of date.\n", filepath);
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::is_current(int image) const
+{
+    ImageEntry const& entry = m_images[image];
+
+    uint64_t size;
+    int64_t  modified;
+    if (!stat_source(entry.name, size, modified)) return true;
+    return size == entry.source_size && modified == entry.source_modified;
+}
+
+void AssetPack::close()
+{
+    if (m_data != NULL) unmap_file(m_data, m_size);
+    m_data   = NULL;
+    m_size   = 0;
+    m_header = NULL;
+    m_pages  = NULL;
+    m_images = NULL;
+    m_delays = NULL;
+}
+
+bool AssetPack::write(const char* filepath, const char* const* image_paths, int image_count,
+                      int mip_levels, bool reduced_precision, int max_size)
+{
+    // ————— DECODE AND LAY OUT ————— //
+    TextureAtlas atlas(max_size);
+    atlas.set_mip_levels(mip_levels);
+    atlas.set_reduced_precision(reduced_precision);
+    std::vector<int>       widths(image_count), heights(image_count);
+    std::vector<Animation> animations(image_count);
+    for (int i = 0; i < image_count; i++) {
+        if (strlen(image_paths[i]) >= NAME_LENGTH) {
+            std::printf("Can't bake %s, the path is too long.\n", image_paths[i]);
+            return false;
+        }
+
+        // decoded exactly as the game would, animated GIFs and all
+        TextureCache::DecodedImage image = TextureCache::decode(image_paths[i], mip_levels);
+        if (image.pixels == NULL) {
+            std::printf("Can't bake %s, it couldn't be decoded.\n", image_paths[i]);
+            return false;
+        }
+
+        atlas.add(image.pixels, image.width, image.height);
+        stbi_image_free(image.pixels);
+        widths[i]     = image.width;
+        heights[i]    = image.height;
+        animations[i] = std::move(image.animation);
+    }
+    atlas.layout();
+
+    // ————— TABLES ————— //
+    Header header;
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version     = VERSION;
+    header.page_count  = (uint32_t) atlas.get_page_count();
+    header.image_count = (uint32_t) image_count;
+
+    std::vector<float> delays;
+    for (Animation const& animation : animations) delays.insert(delays.end(), animation.delays.begin(), animation.delays.end());
+    header.delay_count = (uint32_t) delays.size();
+
+    header.mip_levels        = (uint32_t) mip_levels;
+    header.reduced_precision = reduced_precision ? 1 : 0;
+
+    // encoded up front, the table needs their formats and sizes
+    std::vector<PageEntry> pages(header.page_count);
+    std::vector<std::vector<unsigned char>> encoded(header.page_count);
+    uint64_t offset = sizeof(Header) + pages.size() * sizeof(PageEntry) + image_count * sizeof(ImageEntry)
+                                     + delays.size() * sizeof(float);
+    for (int p = 0; p < (int) pages.size(); p++) {
+        atlas.encode_page(p, encoded[p]);
+
+        offset = (offset + TEXEL_ALIGNMENT - 1) / TEXEL_ALIGNMENT * TEXEL_ALIGNMENT;
+        pages[p].width      = (uint32_t) atlas.get_page_width(p);
+        pages[p].height     = (uint32_t) atlas.get_page_height(p);
+        pages[p].format     = (uint32_t) atlas.get_page_format(p);
+        pages[p].mip_levels = (uint32_t) mip_levels;
+        pages[p].offset     = offset;
+        offset += encoded[p].size();
+    }
+
+    std::vector<ImageEntry> images(image_count);
+    uint32_t first_delay = 0;
+    for (int i = 0; i < image_count; i++) {
+        ImageEntry& entry = images[i];
+        memset(entry.name, 0, NAME_LENGTH);
+        strcpy(entry.name, image_paths[i]);
+
+        int page, x, y;
+        atlas.get_placement(i, page, x, y);
+        entry.page   = (uint32_t) page;
+        entry.x      = x;
+        entry.y      = y;
+        entry.width  = widths[i];
+        entry.height = heights[i];
+
+        entry.frame_count = (uint32_t) animations[i].frame_count;
+        entry.columns     = (uint32_t) animations[i].columns;
+        entry.rows        = (uint32_t) animations[i].rows;
+        entry.first_delay = first_delay;
+        entry.frame_rect[0] = animations[i].frame_rect.x;
+        entry.frame_rect[1] = animations[i].frame_rect.y;
+        entry.frame_rect[2] = animations[i].frame_rect.z;
+        entry.frame_rect[3] = animations[i].frame_rect.w;
+        first_delay += (uint32_t) animations[i].delays.size();
+
+        stat_source(image_paths[i], entry.source_size, entry.source_modified);
+    }
+
+    // ————— WRITE ————— //
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) {
+        std::printf("Can't write asset pack %s.\n", filepath);
+        return false;
+    }
+
+    fwrite(&header, sizeof(Header), 1, file);
+    fwrite(pages.data(), sizeof(PageEntry), pages.size(), file);
+    fwrite(images.data(), sizeof(ImageEntry), images.size(), file);
+    fwrite(delays.data(), sizeof(float), delays.size(), file);
+
+    for (int p = 0; p < (int) pages.size(); p++) {
+        long padding = (long) pages[p].offset - ftell(file);
+        for (long i = 0; i < padding; i++) fputc(0, file);
+
+        fwrite(encoded[p].data(), 1, encoded[p].size(), file);
+    }
+
+    bool written = ferror(file) == 0;
+    fclose(file);
+    return written;
+}
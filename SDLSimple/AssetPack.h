@@ -0,0 +1,96 @@
+#pragma once
+
+// AssetPack: every image the game draws, decoded, laid out on atlas pages and
+// encoded ahead of time, in one file. the file is memory-mapped as is and the
+// pages are uploaded straight out of the mapping, so starting up doesn't decode,
+// convert or copy any texels. build one with --bake-assets (see write()).
+//
+// layout, all little-endian:
+//     Header
+//     PageEntry  [page_count]   texels as TextureAtlas::encode_page() writes them, at offset
+//     ImageEntry [image_count]  where each source file ended up, and its size and
+//                               modification time when it was baked
+//     float      [delay_count]  seconds per frame of every animated image, in order
+//     texels, each page's starting on a TEXEL_ALIGNMENT boundary
+
+#include <cstddef>
+#include <cstdint>
+
+class AssetPack
+{
+public:
+    static const uint32_t VERSION         = 6;
+    static const int      NAME_LENGTH     = 64;
+    static const int      TEXEL_ALIGNMENT = 64;
+
+    struct Header
+    {
+        char     magic[4]; // "LLAP"
+        uint32_t version;
+        uint32_t page_count;
+        uint32_t image_count;
+        uint32_t delay_count;
+        uint32_t mip_levels;        // what it was baked with, see TextureAtlas
+        uint32_t reduced_precision;
+    };
+
+    struct PageEntry
+    {
+        uint32_t width, height;
+        uint32_t format;     // a TextureFormat
+        uint32_t mip_levels;
+        uint64_t offset;
+    };
+
+    struct ImageEntry
+    {
+        char     name[NAME_LENGTH]; // the path it was baked from, null-terminated
+        uint32_t page;
+        int32_t  x, y, width, height;
+        uint32_t frame_count, columns, rows; // its sheet, see TextureCache
+        uint32_t first_delay;                // its frames' delays, if it has more than one
+        float    frame_rect[4];              // where each frame sits in its cell, see Animation
+        uint64_t source_size;                // the file it was baked from, to tell when it's changed
+        int64_t  source_modified;
+    };
+
+private:
+    const unsigned char* m_data = NULL;
+    size_t               m_size = 0;
+
+    const Header*     m_header = NULL;
+    const PageEntry*  m_pages  = NULL;
+    const ImageEntry* m_images = NULL;
+    const float*      m_delays = NULL;
+
+public:
+    // ————— METHODS ————— //
+    // purpose: map filepath and check it's a whole, current pack. false (and nothing
+    //          mapped) if it isn't there or isn't valid
+    bool open(const char* filepath);
+    void close();
+
+    // purpose: the packer: decode every image, lay them out on atlas pages no bigger
+    //          than max_size, encode them with mip_levels and, if reduced_precision,
+    //          16 bit formats allowed (as TextureAtlas would at startup) and write the
+    //          pack to filepath. false if anything failed
+    static bool write(const char* filepath, const char* const* image_paths, int image_count,
+                      int mip_levels = 0, bool reduced_precision = false, int max_size = 2048);
+
+    // purpose: false if image's source file has changed since it was baked, so it
+    //          should be decoded from the file instead. a missing source can't have
+    //          changed, the pack is all there is of it
+    bool is_current(int image) const;
+
+    // ————— GETTERS ————— //
+    bool const is_open() const { return m_data != NULL; };
+
+    int              const  get_page_count()          const { return (int) m_header->page_count; };
+    int              const  get_mip_levels()          const { return (int) m_header->mip_levels; };
+    bool             const  is_reduced_precision()    const { return m_header->reduced_precision != 0; };
+    PageEntry const&        get_page(int page)        const { return m_pages[page]; };
+    const unsigned char*    get_texels(int page)      const { return m_data + m_pages[page].offset; };
+    int              const  get_image_count()         const { return (int) m_header->image_count; };
+    ImageEntry const&       get_image(int image)      const { return m_images[image]; };
+    const float*            get_delays()              const { return m_delays; };
+};
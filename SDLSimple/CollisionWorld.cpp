@@ -0,0 +1,44 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Deterministic.h"
+#include <utility>
+#include "CollisionWorld.h"
+
+void CollisionWorld::add_group(const Collider* colliders, int collider_count, unsigned int layer)
+{
+    ColliderGroup group = { std::vector<Collider>(colliders, colliders + collider_count), layer, -1 };
+
+    if (collider_count >= BROADPHASE_MIN_COLLIDERS) {
+        group.broadphase = (int) m_broadphases.size();
+        m_broadphases.push_back(SpatialHash());
+        m_broadphases.back().build(colliders, collider_count);
+    }
+
+    m_groups.push_back(std::move(group));
+}
+
+void CollisionWorld::clear()
+{
+    m_groups.clear();
+    m_broadphases.clear();
+}
+
+void CollisionWorld::rebuild()
+{
+    for (int i = 0; i < (int) m_groups.size(); i++) {
+        if (m_groups[i].broadphase < 0) continue;
+        m_broadphases[m_groups[i].broadphase].build(m_groups[i].colliders.data(), (int) m_groups[i].colliders.size());
+    }
+}
+
+std::vector<int> const& CollisionWorld::query(int i, glm::vec3 centre, float width, float height) const
+{
+    m_broadphases[m_groups[i].broadphase].query(centre, width, height, m_candidates);
+    return m_candidates;
+}
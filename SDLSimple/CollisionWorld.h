@@ -0,0 +1,55 @@
+#pragma once
+
+// CollisionWorld: every group of colliders in a level, each tagged with a layer.
+// the world keeps its own packed copy of each group, so it doesn't care where
+// the level came from (see Registry).
+// Entity::update(delta_time, world) integrates once and resolves against every
+// group whose layer is in the entity's collision_mask, all in the same pass.
+
+#include <vector>
+#include "Entity.h"
+#include "SpatialHash.h"
+
+// groups at least this big get a spatial hash, smaller ones are just scanned
+#define BROADPHASE_MIN_COLLIDERS 64
+
+// ————— LAYERS ————— //
+// one bit per type_of_entity
+const unsigned int LAYER_PLAYER        = 1u << PLAYER,
+                   LAYER_BADPLATFORM   = 1u << BADPLATFORM,
+                   LAYER_GOODPLATFORM  = 1u << GOODPLATFORM,
+                   LAYER_WALLS         = 1u << WALLS,
+                   LAYER_ALL           = ~0u;
+
+struct ColliderGroup
+{
+    std::vector<Collider> colliders;
+    unsigned int layer;
+    int          broadphase; // index into CollisionWorld's spatial hashes, -1 for a linear scan
+};
+
+class CollisionWorld
+{
+private:
+    std::vector<ColliderGroup> m_groups;
+    std::vector<SpatialHash>   m_broadphases;
+
+    // reused by every query so stepping doesn't allocate
+    mutable std::vector<int> m_candidates;
+
+public:
+    // ————— METHODS ————— //
+    void add_group(const Collider* colliders, int collider_count, unsigned int layer);
+    void clear();
+
+    // purpose: re-file every hashed group, for when colliders have been moved through get_colliders()
+    void rebuild();
+
+    // purpose: indices into group i's colliders that a box at centre could touch
+    std::vector<int> const& query(int i, glm::vec3 centre, float width, float height) const;
+
+    // ————— GETTERS ————— //
+    int                  const get_group_count()  const { return (int) m_groups.size(); };
+    ColliderGroup const&       get_group(int i)   const { return m_groups[i]; };
+    Collider*                  get_colliders(int i)     { return m_groups[i].colliders.data(); };
+};
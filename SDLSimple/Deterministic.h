@@ -0,0 +1,30 @@
+#pragma once
+
+// opt-in bit-exact physics. build lander_core with LANDER_DETERMINISTIC defined and
+// every translation unit that includes this first (all of lander_core's .cpp files)
+// is compiled with strict IEEE float: no fast-math, no fused multiply-add contraction
+// and no x87 excess precision. the integrator and the collision code only use +, -, *,
+// / and fabs, so with those pinned down the same inputs give the same bits on any
+// compiler, machine or thread count. state_hash() in LanderCore.h checks it per tick.
+
+#ifdef LANDER_DETERMINISTIC
+
+#if defined(__FAST_MATH__)
+#error "LANDER_DETERMINISTIC can't be built with -ffast-math"
+#endif
+
+#include <cfloat>
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+#error "LANDER_DETERMINISTIC needs float math done in float (SSE2/NEON), not x87 excess precision"
+#endif
+
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#pragma float_control (precise, on)
+#endif
+
+#endif
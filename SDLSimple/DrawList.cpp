@@ -0,0 +1,71 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include <cstring>
+#include "DrawList.h"
+
+void DrawList::clear()
+{
+    sprites.clear();
+    texts.clear();
+}
+
+void DrawList::add_sprite(unsigned int texture_id, glm::vec3 position, glm::vec2 size, glm::vec4 uv_rect)
+{
+    SpriteCommand command = { texture_id, position, size, uv_rect };
+    sprites.push_back(command);
+}
+
+void DrawList::add_text(int run, const char* text)
+{
+    TextCommand command;
+    command.run = run;
+    strncpy(command.text, text, TextCommand::MAX_LENGTH - 1);
+    command.text[TextCommand::MAX_LENGTH - 1] = '\0';
+    texts.push_back(command);
+}
+
+bool DrawList::same_as(const DrawList& other) const
+{
+    if (sprites.size() != other.sprites.size() || texts.size() != other.texts.size()) return false;
+
+    for (size_t i = 0; i < sprites.size(); i++) {
+        SpriteCommand const& a = sprites[i];
+        SpriteCommand const& b = other.sprites[i];
+        if (a.texture_id != b.texture_id || a.position != b.position ||
+            a.size != b.size || a.uv_rect != b.uv_rect) return false;
+    }
+
+    for (size_t i = 0; i < texts.size(); i++) {
+        if (texts[i].run != other.texts[i].run || strcmp(texts[i].text, other.texts[i].text) != 0) return false;
+    }
+
+    return true;
+}
+
+DrawListQueue::DrawListQueue()
+{
+    m_middle.store(1, std::memory_order_relaxed);
+}
+
+void DrawListQueue::publish()
+{
+    // release: everything written to the back list is visible to whoever takes it
+    int previous = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+    m_back = previous & ~FRESH;
+}
+
+bool DrawListQueue::acquire()
+{
+    if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+
+    // acquire: see everything the producer wrote before publishing
+    int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous & ~FRESH;
+    return true;
+}
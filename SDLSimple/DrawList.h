@@ -0,0 +1,83 @@
+#pragma once
+
+// DrawList: everything the render thread needs to draw one frame, built by the
+// simulation thread and never touched by it again once published. sprites are
+// plain values (texture, where, which part of it) and text is a copy of the
+// string for one of the frontend's TextRuns, so no pointer into the game state
+// crosses threads.
+//
+// DrawListQueue hands lists from one producer thread to one consumer thread
+// through three slots. the producer always fills its own back slot, the
+// consumer always reads its own front slot, and publishing or taking a list is
+// a single atomic exchange with the slot in the middle, so neither side ever
+// takes a lock or waits on the other. if the producer publishes twice before
+// the consumer takes, the older list is simply dropped.
+
+#include <atomic>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+// ————— COMMANDS ————— //
+struct SpriteCommand
+{
+    unsigned int texture_id;
+    glm::vec3    position;
+    glm::vec2    size;
+    glm::vec4    uv_rect;
+};
+
+struct TextCommand
+{
+    static const int MAX_LENGTH = 32;
+
+    int  run;               // which of the frontend's TextRuns draws it
+    char text[MAX_LENGTH];  // always null-terminated
+};
+
+struct DrawList
+{
+    // cleared for every frame, so once they've grown building a list doesn't allocate
+    std::vector<SpriteCommand> sprites;
+    std::vector<TextCommand>   texts;
+
+    void clear();
+    void add_sprite(unsigned int texture_id, glm::vec3 position, glm::vec2 size, glm::vec4 uv_rect);
+
+    // purpose: queue text for run, cut to fit if it's longer than MAX_LENGTH - 1
+    void add_text(int run, const char* text);
+
+    // purpose: true if drawing this would put exactly what other did on screen
+    bool same_as(const DrawList& other) const;
+};
+
+// ————— HANDOFF ————— //
+class DrawListQueue
+{
+private:
+    // set on the middle index while it holds a list the consumer hasn't taken
+    static const int FRESH = 4;
+
+    DrawList m_lists[3];
+
+    int              m_back  = 0; // producer's
+    std::atomic<int> m_middle;
+    int              m_front = 2; // consumer's
+
+public:
+    // ————— METHODS ————— //
+    DrawListQueue();
+
+    // producer: the list to fill, then hand it over
+    DrawList& get_back() { return m_lists[m_back]; };
+    void publish();
+
+    // consumer: swap in the newest published list if there is one, false if not.
+    //           get_front() is the last list taken either way
+    bool acquire();
+    DrawList const& get_front() const { return m_lists[m_front]; };
+
+    // purpose: true while a published list is still waiting for the consumer
+    bool is_pending() const { return (m_middle.load(std::memory_order_acquire) & FRESH) != 0; };
+};
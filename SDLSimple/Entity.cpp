@@ -6,20 +6,12 @@
 //    NYU School of Engineering Policies and Procedures on
 //    Academic Misconduct.
 
-#define GL_SILENCE_DEPRECATION
-#define STB_IMAGE_IMPLEMENTATION
-
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-
-#define GL_GLEXT_PROTOTYPES 1
-#include <SDL.h>
-#include <SDL_opengl.h>
+#include "Deterministic.h"
+#include <cmath>
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
-#include "ShaderProgram.h"
 #include "Entity.h"
+#include "CollisionWorld.h"
 
 // entity constructor
 Entity::Entity()
@@ -31,40 +23,57 @@ Entity::Entity()
     m_model_matrix = glm::mat4(1.0f);
 }
 
-// entity destructor
-Entity::~Entity()
+void Entity::animate(float delta_time)
 {
-    delete[] m_animation_up;
-    delete[] m_animation_down;
-    delete[] m_animation_left;
-    delete[] m_animation_right;
-    delete[] m_walking;
+    if (m_animation_delays == NULL || m_animation_frames < 2) return;
+
+    // at most one lap of the frames per call, so delays of nothing can't spin here forever
+    m_animation_time += delta_time;
+    for (int i = 0; i < m_animation_frames && m_animation_time >= m_animation_delays[m_animation_index]; i++) {
+        m_animation_time -= m_animation_delays[m_animation_index];
+        m_animation_index = (m_animation_index + 1) % m_animation_frames;
+    }
+
+    // still more than a frame behind after a whole lap: drop the rest rather than carry it
+    if (m_animation_time >= m_animation_delays[m_animation_index]) m_animation_time = 0.0f;
+}
+
+glm::vec4 const Entity::get_animation_uv_rect(int index) const
+{
+    float frame_width  = (m_uv_rect.z - m_uv_rect.x) / (float) m_animation_cols;
+    float frame_height = (m_uv_rect.w - m_uv_rect.y) / (float) m_animation_rows;
+
+    float u_coord = m_uv_rect.x + (float) (index % m_animation_cols) * frame_width;
+    float v_coord = m_uv_rect.y + (float) (index / m_animation_cols) * frame_height;
+
+    return glm::vec4(u_coord + m_animation_frame_rect.x * frame_width, v_coord + m_animation_frame_rect.y * frame_height,
+                     u_coord + m_animation_frame_rect.z * frame_width, v_coord + m_animation_frame_rect.w * frame_height);
 }
 
 // purpose: collisions functions
-bool  Entity::check_collision(Entity* other)
+bool  Entity::check_collision(const Collider* other)
 {
-    float x_distance = fabs(m_position.x - other->m_position.x) - ((m_width + other->m_width) / 2.0f);
-    float y_distance = fabs(m_position.y - other->m_position.y) - ((m_height + other->m_height) / 2.0f);
+    float x_distance = fabs(m_position.x - other->position.x) - ((m_width + other->width) / 2.0f);
+    float y_distance = fabs(m_position.y - other->position.y) - ((m_height + other->height) / 2.0f);
     
     if (x_distance < 0.0f && y_distance < 0.0f){
-        collides = other->entity_type;
+        collides = other->type;
         return true;
     }
     return false;
 }
 
 
-void Entity::check_collision_y(Entity* objects, int objectCount)
+void Entity::check_collision_y(const Collider* objects, int objectCount)
 {
     for (int i = 0; i < objectCount; i++)
     {
-        Entity* object = &objects[i];
+        const Collider* object = &objects[i];
 
         if (check_collision(object))
         {
-            float y_distance = fabs(m_position.y - object->m_position.y);
-            float y_diff = fabs(y_distance - (m_height / 2.0f) - (object->m_height / 2.0f));
+            float y_distance = fabs(m_position.y - object->position.y);
+            float y_diff = fabs(y_distance - (m_height / 2.0f) - (object->height / 2.0f));
             if (m_velocity.y > 0) {
                 m_position.y -= y_diff;
                 m_velocity.y = 0;
@@ -79,16 +88,16 @@ void Entity::check_collision_y(Entity* objects, int objectCount)
     }
 }
 
-void Entity::check_collision_x(Entity* objects, int objectCount)
+void Entity::check_collision_x(const Collider* objects, int objectCount)
 {
     for (int i = 0; i < objectCount; i++)
     {
-        Entity* object = &objects[i];
+        const Collider* object = &objects[i];
 
         if (check_collision(object))
         {
-            float x_distance = fabs(m_position.x - object->m_position.x);
-            float x_diff = fabs(x_distance - (m_width / 2.0f) - (object->m_width / 2.0f));
+            float x_distance = fabs(m_position.x - object->position.x);
+            float x_diff = fabs(x_distance - (m_width / 2.0f) - (object->width / 2.0f));
             if (m_velocity.x > 0) {
                 m_position.x -= x_diff;
                 m_velocity.x = 0;
@@ -103,7 +112,79 @@ void Entity::check_collision_x(Entity* objects, int objectCount)
     }
 }
 
-void Entity::update(float delta_time, Entity* collidable_entities, int collidable_entity_count)
+// purpose: continuous collisions. shortens distance (the move along y this step) to
+//          the gap in front of the nearest collider the box lines up with on x, and
+//          remembers that collider. ones already overlapping are left to check_collision_y.
+void Entity::sweep_y(const Collider* objects, int objectCount, float& distance, const Collider*& hit)
+{
+    for (int i = 0; i < objectCount; i++)
+    {
+        const Collider* object = &objects[i];
+
+        float x_distance = fabs(m_position.x - object->position.x) - ((m_width + object->width) / 2.0f);
+        if (x_distance >= 0.0f) continue;
+
+        if (distance > 0) {
+            float gap = (object->position.y - object->height / 2.0f) - (m_position.y + m_height / 2.0f);
+            if (gap >= 0.0f && gap < distance) {
+                distance = gap;
+                hit = object;
+            }
+        }
+        else if (distance < 0) {
+            float gap = (object->position.y + object->height / 2.0f) - (m_position.y - m_height / 2.0f);
+            if (gap <= 0.0f && gap > distance) {
+                distance = gap;
+                hit = object;
+            }
+        }
+    }
+}
+
+void Entity::sweep_x(const Collider* objects, int objectCount, float& distance, const Collider*& hit)
+{
+    for (int i = 0; i < objectCount; i++)
+    {
+        const Collider* object = &objects[i];
+
+        float y_distance = fabs(m_position.y - object->position.y) - ((m_height + object->height) / 2.0f);
+        if (y_distance >= 0.0f) continue;
+
+        if (distance > 0) {
+            float gap = (object->position.x - object->width / 2.0f) - (m_position.x + m_width / 2.0f);
+            if (gap >= 0.0f && gap < distance) {
+                distance = gap;
+                hit = object;
+            }
+        }
+        else if (distance < 0) {
+            float gap = (object->position.x + object->width / 2.0f) - (m_position.x - m_width / 2.0f);
+            if (gap <= 0.0f && gap > distance) {
+                distance = gap;
+                hit = object;
+            }
+        }
+    }
+}
+
+// purpose: what check_collision_y would have done after pushing us back out of hit
+void Entity::land_y(const Collider* hit)
+{
+    collides = hit->type;
+    if (m_velocity.y > 0) m_collided_top = true;
+    else                  m_collided_bottom = true;
+    m_velocity.y = 0;
+}
+
+void Entity::land_x(const Collider* hit)
+{
+    collides = hit->type;
+    if (m_velocity.x > 0) m_collided_right = true;
+    else                  m_collided_left = true;
+    m_velocity.x = 0;
+}
+
+void Entity::update(float delta_time, const Collider* colliders, int collider_count)
 {
     // if the entity is a bad platform or walls, return
     if (entity_type == BADPLATFORM || entity_type == WALLS) {
@@ -113,33 +194,121 @@ void Entity::update(float delta_time, Entity* collidable_entities, int collidabl
     // updating position and velocity, calling check_collision functions
     m_velocity += m_acceleration * delta_time;
         
-    m_position.y += m_velocity.y * delta_time;
-    check_collision_y(collidable_entities, collidable_entity_count);
+    if (m_continuous_collision) {
+        float distance = m_velocity.y * delta_time;
+        const Collider* hit = NULL;
+        sweep_y(colliders, collider_count, distance, hit);
+        m_position.y += distance;
+        if (hit) land_y(hit);
+    }
+    else m_position.y += m_velocity.y * delta_time;
+    check_collision_y(colliders, collider_count);
 
-    m_position.x += m_velocity.x * delta_time;
-    check_collision_x(collidable_entities, collidable_entity_count);
+    if (m_continuous_collision) {
+        float distance = m_velocity.x * delta_time;
+        const Collider* hit = NULL;
+        sweep_x(colliders, collider_count, distance, hit);
+        m_position.x += distance;
+        if (hit) land_x(hit);
+    }
+    else m_position.x += m_velocity.x * delta_time;
+    check_collision_x(colliders, collider_count);
     
     // general transform stuff
     m_model_matrix = glm::mat4(1.0f);
     m_model_matrix = glm::translate(m_model_matrix, m_position);
 }
 
-void Entity::render(ShaderProgram* program)
+// purpose: one integration per tick against every group in the world the entity's mask allows
+void Entity::update(float delta_time, const CollisionWorld& world)
 {
-    program->set_model_matrix(m_model_matrix);
+    if (entity_type == BADPLATFORM || entity_type == WALLS) {
+            return;
+    }
 
-    float vertices[]   = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
-    float tex_coords[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
+    m_velocity += m_acceleration * delta_time;
 
-    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    if (m_continuous_collision) {
+        float distance = m_velocity.y * delta_time;
+        const Collider* hit = NULL;
+        sweep_world_y(world, distance, hit);
+        m_position.y += distance;
+        if (hit) land_y(hit);
+    }
+    else m_position.y += m_velocity.y * delta_time;
 
-    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
-    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+    for (int i = 0; i < world.get_group_count(); i++) {
+        ColliderGroup const& group = world.get_group(i);
+        if (!(group.layer & collision_mask)) continue;
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+        if (group.broadphase < 0) {
+            check_collision_y(group.colliders.data(), (int) group.colliders.size());
+            continue;
+        }
+        // only the nearby colliders, in the same order a full scan would visit them
+        std::vector<int> const& candidates = world.query(i, m_position, m_width, m_height);
+        for (int j = 0; j < (int) candidates.size(); j++) check_collision_y(&group.colliders[candidates[j]], 1);
+    }
 
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+    if (m_continuous_collision) {
+        float distance = m_velocity.x * delta_time;
+        const Collider* hit = NULL;
+        sweep_world_x(world, distance, hit);
+        m_position.x += distance;
+        if (hit) land_x(hit);
+    }
+    else m_position.x += m_velocity.x * delta_time;
+
+    for (int i = 0; i < world.get_group_count(); i++) {
+        ColliderGroup const& group = world.get_group(i);
+        if (!(group.layer & collision_mask)) continue;
+
+        if (group.broadphase < 0) {
+            check_collision_x(group.colliders.data(), (int) group.colliders.size());
+            continue;
+        }
+        std::vector<int> const& candidates = world.query(i, m_position, m_width, m_height);
+        for (int j = 0; j < (int) candidates.size(); j++) check_collision_x(&group.colliders[candidates[j]], 1);
+    }
+
+    m_model_matrix = glm::mat4(1.0f);
+    m_model_matrix = glm::translate(m_model_matrix, m_position);
+}
+
+// purpose: sweep_y over every group in the world the entity's mask allows
+void Entity::sweep_world_y(const CollisionWorld& world, float& distance, const Collider*& hit)
+{
+    // the box covering the whole move, for the broadphase
+    glm::vec3 centre = m_position + glm::vec3(0.0f, distance / 2.0f, 0.0f);
+    float     height = m_height + fabs(distance);
+
+    for (int i = 0; i < world.get_group_count(); i++) {
+        ColliderGroup const& group = world.get_group(i);
+        if (!(group.layer & collision_mask)) continue;
+
+        if (group.broadphase < 0) {
+            sweep_y(group.colliders.data(), (int) group.colliders.size(), distance, hit);
+            continue;
+        }
+        std::vector<int> const& candidates = world.query(i, centre, m_width, height);
+        for (int j = 0; j < (int) candidates.size(); j++) sweep_y(&group.colliders[candidates[j]], 1, distance, hit);
+    }
+}
+
+void Entity::sweep_world_x(const CollisionWorld& world, float& distance, const Collider*& hit)
+{
+    glm::vec3 centre = m_position + glm::vec3(distance / 2.0f, 0.0f, 0.0f);
+    float     width  = m_width + fabs(distance);
+
+    for (int i = 0; i < world.get_group_count(); i++) {
+        ColliderGroup const& group = world.get_group(i);
+        if (!(group.layer & collision_mask)) continue;
+
+        if (group.broadphase < 0) {
+            sweep_x(group.colliders.data(), (int) group.colliders.size(), distance, hit);
+            continue;
+        }
+        std::vector<int> const& candidates = world.query(i, centre, width, m_height);
+        for (int j = 0; j < (int) candidates.size(); j++) sweep_x(&group.colliders[candidates[j]], 1, distance, hit);
+    }
 }
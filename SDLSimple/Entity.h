@@ -1,10 +1,32 @@
+#pragma once
+
+// no SDL or OpenGL in here: Entity is part of lander_core. the game draws it
+// through the sprite batch, from m_texture_id and m_uv_rect
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+
+class CollisionWorld;
+
 enum type_of_entity {PLAYER, BADPLATFORM, GOODPLATFORM, WALLS};
+
+// a static box the player collides with, packed so collision loops only touch what they read
+struct Collider
+{
+    glm::vec3      position;
+    float          width;
+    float          height;
+    type_of_entity type;
+};
+
 class Entity
 {
 private:
     bool m_is_active = true;
 
     // ––––– ANIMATION ––––– //
+    // these point at frame tables owned elsewhere, never at the entity's own heap,
+    // so an Entity stays trivially copyable (see LanderState)
     int*  m_animation_right = NULL, // move to the right
         * m_animation_left  = NULL, // move to the left
         * m_animation_up    = NULL, // move upwards
@@ -23,11 +45,23 @@ private:
     float m_width = 1;
     float m_height = 1;
 
+    // ––––– PHYSICS (CONTINUOUS COLLISIONS) ––––– //
+    // sweep the box along each axis and stop at the first collider it would touch,
+    // so big steps can't tunnel through thin colliders like the walls
+    bool m_continuous_collision = false;
+
+    void sweep_y(const Collider* colliders, int collider_count, float& distance, const Collider*& hit);
+    void sweep_x(const Collider* colliders, int collider_count, float& distance, const Collider*& hit);
+    void land_y(const Collider* hit);
+    void land_x(const Collider* hit);
+    void sweep_world_y(const CollisionWorld& world, float& distance, const Collider*& hit);
+    void sweep_world_x(const CollisionWorld& world, float& distance, const Collider*& hit);
 
 public:
     // ————— STATIC VARIABLES ————— //
-    type_of_entity entity_type;
-    type_of_entity collides;
+    type_of_entity entity_type = PLAYER;
+    type_of_entity collides    = PLAYER; // PLAYER means nothing has been hit yet
+    unsigned int   collision_mask = ~0u; // which CollisionWorld layers this entity collides with
     static const int SECONDS_PER_FRAME = 4;
     static const int LEFT   = 0,
                      RIGHT  = 1,
@@ -35,7 +69,7 @@ public:
                      DOWN   = 3;
 
     // ————— ANIMATION ————— //
-    int** m_walking = new int* [4]
+    int* m_walking[4] =
         {
             m_animation_left,
             m_animation_right,
@@ -51,6 +85,12 @@ public:
     int* m_animation_indices = NULL;
     float m_animation_time   = 0.0f;
 
+    // seconds each frame shows for, m_animation_frames of them. owned elsewhere
+    // (the texture cache), like the frame tables above. NULL for a still sprite
+    const float* m_animation_delays = NULL;
+    // the part of each cell that's the frame itself, as fractions of the cell
+    glm::vec4 m_animation_frame_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
     // ––––– PHYSICS (JUMPING) ––––– //
     bool  m_is_jumping     = false;
     float m_jumping_power  = 0;
@@ -61,19 +101,21 @@ public:
     bool m_collided_left   = false;
     bool m_collided_right  = false;
 
-    GLuint    m_texture_id;
+    unsigned int m_texture_id = 0; // GLuint, kept GL-free for the headless build
+    glm::vec4    m_uv_rect    = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); // (u0, v0, u1, v1) of the texture this sprite uses
 
     // ————— METHODS ————— //
     Entity();
-    ~Entity();
 
-    void draw_sprite_from_texture_atlas(ShaderProgram* program, GLuint texture_id, int index);
-    bool  check_collision(Entity* other);
-    void  check_collision_y(Entity* collidable_entities, int collidable_entity_count);
-    void  check_collision_x(Entity* collidable_entities, int collidable_entity_count);
+    // purpose: move through the frames by m_animation_delays. only the frame index
+    //          changes, the frames are all already in the texture
+    void animate(float delta_time);
+    bool  check_collision(const Collider* other);
+    void  check_collision_y(const Collider* colliders, int collider_count);
+    void  check_collision_x(const Collider* colliders, int collider_count);
 
-    void update(float delta_time, Entity* collidable_entities, int collidable_entity_count);
-    void render(ShaderProgram* program);
+    void update(float delta_time, const Collider* colliders, int collider_count);
+    void update(float delta_time, const CollisionWorld& world);
     
     void move_left()  { m_acceleration.x = -0.02f; };
     void move_right() { m_acceleration.x = 0.02f;  };
@@ -87,9 +129,14 @@ public:
     glm::vec3 const get_velocity()     const { return m_velocity; };
     glm::vec3 const get_acceleration() const { return m_acceleration; };
     glm::vec3 const get_movement()     const { return m_movement; };
+    glm::mat4 const get_model_matrix() const { return m_model_matrix; };
+    bool      const get_continuous_collision() const { return m_continuous_collision; };
     float     const get_speed()        const { return m_speed; };
-    int       const get_width()        const { return m_width; };
-    int       const get_height()       const { return m_height; };
+    float     const get_width()        const { return m_width; };
+    float     const get_height()       const { return m_height; };
+
+    // the part of m_uv_rect frame index covers, in an m_animation_cols x m_animation_rows sheet
+    glm::vec4 const get_animation_uv_rect(int index) const;
 
     // ————— SETTERS ————— //
     void const set_position(glm::vec3 new_position)         { m_position = new_position; };
@@ -107,6 +154,8 @@ public:
     }
     
     void const set_movement(glm::vec3 new_movement)         { m_movement = new_movement; };
+    void const set_model_matrix(glm::mat4 new_matrix)       { m_model_matrix = new_matrix; };
+    void const set_continuous_collision(bool enabled)       { m_continuous_collision = enabled; };
     void const set_speed(float new_speed)                   { m_speed = new_speed; };
     void const set_width(float new_width)                   { m_width = new_width; };
     void const set_height(float new_height)                 { m_height = new_height; };
@@ -0,0 +1,38 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "FramePacer.h"
+
+void FramePacer::initialise(int frames_per_second)
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_period    = m_frequency / frames_per_second;
+    reset();
+}
+
+void FramePacer::reset()
+{
+    m_deadline = SDL_GetPerformanceCounter();
+}
+
+void FramePacer::wait()
+{
+    m_deadline += m_period;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now >= m_deadline) {
+        // more than a frame late: drop the missed frames rather than running them back to back
+        if (now - m_deadline > m_period) m_deadline = now;
+        return;
+    }
+
+    Uint32 milliseconds = (Uint32) ((m_deadline - now) * 1000 / m_frequency);
+    if (milliseconds > SPIN_MILLISECONDS) SDL_Delay(milliseconds - SPIN_MILLISECONDS);
+
+    while (SDL_GetPerformanceCounter() < m_deadline) {}
+}
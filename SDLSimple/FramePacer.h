@@ -0,0 +1,33 @@
+#pragma once
+
+// FramePacer: keeps a loop to a fixed frame rate without burning a core. wait()
+// sleeps until the next frame is due, but SDL_Delay is only good to a
+// millisecond or two, so it sleeps short of the deadline and spins the rest on
+// the high-resolution counter. a loop that falls more than a frame behind
+// starts again from now instead of rushing to catch up.
+
+#include <SDL.h>
+
+class FramePacer
+{
+private:
+    // how much of every wait is spun instead of slept
+    static const Uint32 SPIN_MILLISECONDS = 2;
+
+    Uint64 m_frequency = 0;
+    Uint64 m_period    = 0; // counter ticks per frame
+    Uint64 m_deadline  = 0;
+
+public:
+    // ————— METHODS ————— //
+    void initialise(int frames_per_second);
+
+    // purpose: block until the next frame is due
+    void wait();
+
+    // purpose: start the schedule again from now, after the loop has been idle
+    void reset();
+
+    // ————— GETTERS ————— //
+    float const get_frame_time() const { return (float) m_period / m_frequency; };
+};
@@ -0,0 +1,153 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstring>
+#include "InstancedSpriteBatch.h"
+
+// the ARB entry points are used throughout: they're what the legacy (2.1) contexts
+// SDL gives us on macOS expose, and 3.3+ drivers still export them
+
+bool InstancedSpriteBatch::is_supported()
+{
+    const char* extensions = (const char*) glGetString(GL_EXTENSIONS);
+    return extensions != NULL &&
+           strstr(extensions, "GL_ARB_instanced_arrays") != NULL &&
+           strstr(extensions, "GL_ARB_draw_instanced")   != NULL;
+}
+
+void InstancedSpriteBatch::initialise(ShaderProgram* program, StreamBuffer* stream)
+{
+    // unit quad: x, y, u, v, in the same order as Entity::render
+    float quad[] = {
+        -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f, 0.0f, 0.0f,
+    };
+
+    glGenBuffers(1, &m_quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_stream = stream;
+    if (m_stream == NULL) glGenBuffers(1, &m_instance_buffer);
+
+    m_instance_position_attribute = glGetAttribLocation(program->get_program_id(), "instancePosition");
+    m_instance_scale_attribute    = glGetAttribLocation(program->get_program_id(), "instanceScale");
+    m_instance_uv_attribute       = glGetAttribLocation(program->get_program_id(), "instanceUV");
+}
+
+void InstancedSpriteBatch::shutdown()
+{
+    glDeleteBuffers(1, &m_quad_buffer);
+    if (m_instance_buffer != 0) glDeleteBuffers(1, &m_instance_buffer);
+    m_quad_buffer     = 0;
+    m_instance_buffer = 0;
+    m_stream          = NULL;
+}
+
+void InstancedSpriteBatch::begin()
+{
+    m_instances.clear();
+    m_instance_textures.clear();
+}
+
+void InstancedSpriteBatch::draw(GLuint texture_id, glm::vec3 position, glm::vec2 size, glm::vec4 uv_rect)
+{
+    m_instances.insert(m_instances.end(), {
+        position.x, position.y, size.x, size.y,
+        uv_rect.x, uv_rect.y, uv_rect.z, uv_rect.w,
+    });
+    m_instance_textures.push_back(texture_id);
+}
+
+void InstancedSpriteBatch::end(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    int instance_count = get_quad_count();
+    if (instance_count == 0) return;
+
+    // group by texture, keeping submission order inside each group (same as SpriteBatch)
+    m_order.resize(instance_count);
+    for (int i = 0; i < instance_count; i++) m_order[i] = i;
+    std::stable_sort(m_order.begin(), m_order.end(),
+                     [this](int a, int b) { return m_instance_textures[a] < m_instance_textures[b]; });
+
+    m_sorted.resize(m_instances.size());
+    for (int i = 0; i < instance_count; i++) {
+        std::copy(m_instances.begin() + m_order[i] * FLOATS_PER_INSTANCE,
+                  m_instances.begin() + (m_order[i] + 1) * FLOATS_PER_INSTANCE,
+                  m_sorted.begin() + i * FLOATS_PER_INSTANCE);
+    }
+
+    program->use();
+
+    // the shared quad
+    GLsizei quad_stride = 4 * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, quad_stride, (void*) 0);
+    ShaderProgram::enable_attribute(program->get_position_attribute());
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, quad_stride, (void*) (2 * sizeof(float)));
+    ShaderProgram::enable_attribute(program->get_tex_coordinate_attribute());
+
+    // this frame's instances: appended to the stream, or else orphaning last frame's storage
+    GLintptr base = 0;
+    if (m_stream != NULL) {
+        base = m_stream->write(m_sorted.data(), m_sorted.size() * sizeof(float));
+    }
+    else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+        glBufferData(GL_ARRAY_BUFFER, m_sorted.size() * sizeof(float), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_sorted.size() * sizeof(float), m_sorted.data());
+    }
+
+    GLint instance_attributes[] = { m_instance_position_attribute, m_instance_scale_attribute, m_instance_uv_attribute };
+    GLint components[]          = { 2, 2, 4 };
+    GLsizei instance_stride     = FLOATS_PER_INSTANCE * sizeof(float);
+
+    for (int i = 0; i < 3; i++) {
+        ShaderProgram::enable_attribute(instance_attributes[i]);
+        glVertexAttribDivisorARB(instance_attributes[i], 1);
+    }
+
+    // one instanced draw per run of quads sharing a texture
+    int first = 0;
+    while (first < instance_count) {
+        GLuint texture_id = m_instance_textures[m_order[first]];
+        int last = first + 1;
+        while (last < instance_count && m_instance_textures[m_order[last]] == texture_id) last++;
+
+        // start the instance attributes at this run
+        int offset = 0;
+        for (int i = 0; i < 3; i++) {
+            glVertexAttribPointer(instance_attributes[i], components[i], GL_FLOAT, false, instance_stride,
+                                  (void*) (base + (first * FLOATS_PER_INSTANCE + offset) * sizeof(float)));
+            offset += components[i];
+        }
+
+        ShaderProgram::bind_texture(texture_id);
+        glDrawArraysInstancedARB(GL_TRIANGLES, 0, 6, last - first);
+        m_draw_calls++;
+
+        first = last;
+    }
+
+    // other programs may reuse these attribute slots without instancing
+    for (int i = 0; i < 3; i++) {
+        glVertexAttribDivisorARB(instance_attributes[i], 0);
+        ShaderProgram::disable_attribute(instance_attributes[i]);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
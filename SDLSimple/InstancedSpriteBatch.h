@@ -0,0 +1,63 @@
+#pragma once
+
+// InstancedSpriteBatch: SpriteBatch's interface, drawn with instancing. each quad
+// is 8 floats in an instance buffer (position, size, UV rect) instead of 6
+// transformed vertices, and every texture's quads go out in one
+// glDrawArraysInstanced over a shared unit quad. needs a program built from
+// shaders/vertex_instanced.glsl, and is_supported() to be true. like
+// SpriteBatch, given a StreamBuffer it appends each frame's instances there
+// instead of respecifying a buffer of its own.
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "ShaderProgram.h"
+#include "StreamBuffer.h"
+
+class InstancedSpriteBatch
+{
+private:
+    // x, y, width, height, u0, v0, u1, v1
+    static const int FLOATS_PER_INSTANCE = 8;
+
+    GLuint        m_quad_buffer     = 0;
+    GLuint        m_instance_buffer = 0; // only made when there's no stream
+    StreamBuffer* m_stream          = NULL;
+
+    GLint m_instance_position_attribute = -1;
+    GLint m_instance_scale_attribute    = -1;
+    GLint m_instance_uv_attribute       = -1;
+
+    std::vector<float>  m_instances;
+    std::vector<GLuint> m_instance_textures;
+
+    // reused every frame so end() doesn't allocate once the batch has warmed up
+    std::vector<int>   m_order;
+    std::vector<float> m_sorted;
+
+    int m_draw_calls = 0;
+
+public:
+    // ————— METHODS ————— //
+    // purpose: true if the context has instanced arrays (GL 3.3, or the ARB extensions on 2.1)
+    static bool is_supported();
+
+    // purpose: make the buffers and look up the instance attributes in program
+    void initialise(ShaderProgram* program, StreamBuffer* stream = NULL);
+    void shutdown();
+
+    void begin();
+    void draw(GLuint texture_id, glm::vec3 position, glm::vec2 size = glm::vec2(1.0f),
+              glm::vec4 uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+    void end(ShaderProgram* program);
+
+    // ————— GETTERS ————— //
+    int const get_quad_count() const { return (int) m_instance_textures.size(); };
+    int const get_draw_calls() const { return m_draw_calls; }; // issued by the last end()
+};
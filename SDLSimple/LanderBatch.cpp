@@ -0,0 +1,324 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Deterministic.h"
+
+// let glm's platform detection pick the widest instruction set the compiler is
+// targeting (GLM_ARCH_AVX2 with -mavx2, SSE2 on any x86-64 build)
+#define GLM_FORCE_INTRINSICS
+#include "glm/simd/platform.h"
+
+#include <cmath>
+#include "LanderBatch.h"
+
+// ————— SIMD LANES ————— //
+// the kernel below is written once against these wrappers. every operation matches
+// the scalar code in Entity.cpp one for one (no reassociation, no fused multiply-add)
+// so each lane ends up bit-identical to Entity::update.
+#if GLM_ARCH & GLM_ARCH_AVX2_BIT
+struct Lanes
+{
+    typedef __m256 f;
+    static const int WIDTH = 8;
+    static const char* name() { return "AVX2"; }
+
+    static f    load(const float* p)       { return _mm256_loadu_ps(p); }
+    static void store(float* p, f v)       { _mm256_storeu_ps(p, v); }
+    static f    set(float x)               { return _mm256_set1_ps(x); }
+    static f    zero()                     { return _mm256_setzero_ps(); }
+    static f    add(f a, f b)              { return _mm256_add_ps(a, b); }
+    static f    sub(f a, f b)              { return _mm256_sub_ps(a, b); }
+    static f    mul(f a, f b)              { return _mm256_mul_ps(a, b); }
+    static f    abs(f a)                   { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static f    less(f a, f b)             { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static f    bit_and(f a, f b)          { return _mm256_and_ps(a, b); }
+    static f    bit_or(f a, f b)           { return _mm256_or_ps(a, b); }
+    static f    select(f mask, f a, f b)   { return _mm256_blendv_ps(b, a, mask); }
+    static bool any(f mask)                { return _mm256_movemask_ps(mask) != 0; }
+};
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+struct Lanes
+{
+    typedef __m128 f;
+    static const int WIDTH = 4;
+    static const char* name() { return "SSE2"; }
+
+    static f    load(const float* p)       { return _mm_loadu_ps(p); }
+    static void store(float* p, f v)       { _mm_storeu_ps(p, v); }
+    static f    set(float x)               { return _mm_set1_ps(x); }
+    static f    zero()                     { return _mm_setzero_ps(); }
+    static f    add(f a, f b)              { return _mm_add_ps(a, b); }
+    static f    sub(f a, f b)              { return _mm_sub_ps(a, b); }
+    static f    mul(f a, f b)              { return _mm_mul_ps(a, b); }
+    static f    abs(f a)                   { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static f    less(f a, f b)             { return _mm_cmplt_ps(a, b); }
+    static f    bit_and(f a, f b)          { return _mm_and_ps(a, b); }
+    static f    bit_or(f a, f b)           { return _mm_or_ps(a, b); }
+    static f    select(f mask, f a, f b)   { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    static bool any(f mask)                { return _mm_movemask_ps(mask) != 0; }
+};
+#else
+#define LANDER_BATCH_SCALAR_ONLY
+#endif
+
+// sizes in LanderBatch are padded to this many lanes
+#ifdef LANDER_BATCH_SCALAR_ONLY
+const int BATCH_WIDTH = 1;
+#else
+const int BATCH_WIDTH = Lanes::WIDTH;
+#endif
+
+// ————— CONSTRUCTOR ————— //
+LanderBatch::LanderBatch(int lander_count)
+{
+    m_lander_count = lander_count;
+    m_padded_count = (lander_count + BATCH_WIDTH - 1) / BATCH_WIDTH * BATCH_WIDTH;
+
+    std::vector<float>* per_lander[] =
+    {
+        &m_position_x, &m_position_y, &m_velocity_x, &m_velocity_y,
+        &m_acceleration_x, &m_acceleration_y, &m_width, &m_height,
+        &m_collides, &m_collided_top, &m_collided_bottom, &m_collided_left, &m_collided_right,
+    };
+    for (std::vector<float>* array : per_lander) array->assign(m_padded_count, 0.0f);
+
+    // same defaults as a fresh Entity
+    m_width.assign(m_padded_count, 1.0f);
+    m_height.assign(m_padded_count, 1.0f);
+    m_collides.assign(m_padded_count, (float) PLAYER);
+}
+
+// ————— COLLIDERS ————— //
+void LanderBatch::add_colliders(const Collider* colliders, int collider_count)
+{
+    for (int i = 0; i < collider_count; i++) {
+        m_collider_x.push_back(colliders[i].position.x);
+        m_collider_y.push_back(colliders[i].position.y);
+        m_collider_width.push_back(colliders[i].width);
+        m_collider_height.push_back(colliders[i].height);
+        m_collider_type.push_back((float) colliders[i].type);
+    }
+}
+
+void LanderBatch::clear_colliders()
+{
+    m_collider_x.clear();
+    m_collider_y.clear();
+    m_collider_width.clear();
+    m_collider_height.clear();
+    m_collider_type.clear();
+}
+
+// ————— LANDERS ————— //
+void LanderBatch::reset(int index, const Entity& lander)
+{
+    m_position_x[index]     = lander.get_position().x;
+    m_position_y[index]     = lander.get_position().y;
+    m_velocity_x[index]     = lander.get_velocity().x;
+    m_velocity_y[index]     = lander.get_velocity().y;
+    m_acceleration_x[index] = lander.get_acceleration().x;
+    m_acceleration_y[index] = lander.get_acceleration().y;
+    m_width[index]          = lander.get_width();
+    m_height[index]         = lander.get_height();
+
+    m_collides[index]        = (float) lander.collides;
+    m_collided_top[index]    = lander.m_collided_top;
+    m_collided_bottom[index] = lander.m_collided_bottom;
+    m_collided_left[index]   = lander.m_collided_left;
+    m_collided_right[index]  = lander.m_collided_right;
+}
+
+// purpose: same rules as step() in LanderCore.cpp
+void LanderBatch::apply_input(const LanderInput* inputs)
+{
+    for (int i = 0; i < m_lander_count; i++) {
+        if (inputs[i].left) m_acceleration_x[i] = -0.02f;
+        else                m_acceleration_x[i] = 0.0f;
+
+        if (inputs[i].right) m_acceleration_x[i] = 0.02f;
+
+        if (inputs[i].up) m_acceleration_y[i] = 0.02f;
+        else              m_acceleration_y[i] = ACC_OF_GRAVITY;
+    }
+}
+
+void LanderBatch::step(float delta_time)
+{
+#ifdef LANDER_BATCH_SCALAR_ONLY
+    step_scalar(0, m_padded_count, delta_time);
+#else
+    step_simd(0, m_padded_count, delta_time);
+#endif
+}
+
+const char* LanderBatch::simd_path()
+{
+#ifdef LANDER_BATCH_SCALAR_ONLY
+    return "scalar";
+#else
+    return Lanes::name();
+#endif
+}
+
+// purpose: Entity::update, one lander at a time, over the SoA arrays
+void LanderBatch::step_scalar(int begin, int end, float delta_time)
+{
+    int collider_count = get_collider_count();
+
+    for (int i = begin; i < end; i++) {
+        m_velocity_x[i] += m_acceleration_x[i] * delta_time;
+        m_velocity_y[i] += m_acceleration_y[i] * delta_time;
+
+        m_position_y[i] += m_velocity_y[i] * delta_time;
+        for (int j = 0; j < collider_count; j++) {
+            float x_distance = fabs(m_position_x[i] - m_collider_x[j]) - ((m_width[i] + m_collider_width[j]) / 2.0f);
+            float y_distance = fabs(m_position_y[i] - m_collider_y[j]) - ((m_height[i] + m_collider_height[j]) / 2.0f);
+            if (!(x_distance < 0.0f && y_distance < 0.0f)) continue;
+
+            m_collides[i] = m_collider_type[j];
+
+            float y_gap  = fabs(m_position_y[i] - m_collider_y[j]);
+            float y_diff = fabs(y_gap - (m_height[i] / 2.0f) - (m_collider_height[j] / 2.0f));
+            if (m_velocity_y[i] > 0) {
+                m_position_y[i] -= y_diff;
+                m_velocity_y[i] = 0;
+                m_collided_top[i] = 1.0f;
+            }
+            else if (m_velocity_y[i] < 0) {
+                m_position_y[i] += y_diff;
+                m_velocity_y[i] = 0;
+                m_collided_bottom[i] = 1.0f;
+            }
+        }
+
+        m_position_x[i] += m_velocity_x[i] * delta_time;
+        for (int j = 0; j < collider_count; j++) {
+            float x_distance = fabs(m_position_x[i] - m_collider_x[j]) - ((m_width[i] + m_collider_width[j]) / 2.0f);
+            float y_distance = fabs(m_position_y[i] - m_collider_y[j]) - ((m_height[i] + m_collider_height[j]) / 2.0f);
+            if (!(x_distance < 0.0f && y_distance < 0.0f)) continue;
+
+            m_collides[i] = m_collider_type[j];
+
+            float x_gap  = fabs(m_position_x[i] - m_collider_x[j]);
+            float x_diff = fabs(x_gap - (m_width[i] / 2.0f) - (m_collider_width[j] / 2.0f));
+            if (m_velocity_x[i] > 0) {
+                m_position_x[i] -= x_diff;
+                m_velocity_x[i] = 0;
+                m_collided_right[i] = 1.0f;
+            }
+            else if (m_velocity_x[i] < 0) {
+                m_position_x[i] += x_diff;
+                m_velocity_x[i] = 0;
+                m_collided_left[i] = 1.0f;
+            }
+        }
+    }
+}
+
+#ifdef LANDER_BATCH_SCALAR_ONLY
+void LanderBatch::step_simd(int begin, int end, float delta_time)
+{
+    step_scalar(begin, end, delta_time);
+}
+#else
+// purpose: the same thing as step_scalar, Lanes::WIDTH landers at a time. colliders
+// are still visited in order, so a lander's later collision checks see the position
+// the earlier ones pushed it to, exactly like the scalar loop.
+void LanderBatch::step_simd(int begin, int end, float delta_time)
+{
+    typedef Lanes::f f;
+
+    const f dt   = Lanes::set(delta_time);
+    const f half = Lanes::set(0.5f); // x / 2.0f and x * 0.5f round identically
+    const f one  = Lanes::set(1.0f);
+    const f zero = Lanes::zero();
+
+    int collider_count = get_collider_count();
+
+    for (int i = begin; i < end; i += Lanes::WIDTH) {
+        f position_x = Lanes::load(&m_position_x[i]);
+        f position_y = Lanes::load(&m_position_y[i]);
+        f velocity_x = Lanes::load(&m_velocity_x[i]);
+        f velocity_y = Lanes::load(&m_velocity_y[i]);
+        f width      = Lanes::load(&m_width[i]);
+        f height     = Lanes::load(&m_height[i]);
+        f collides   = Lanes::load(&m_collides[i]);
+        f top        = Lanes::load(&m_collided_top[i]);
+        f bottom     = Lanes::load(&m_collided_bottom[i]);
+        f left       = Lanes::load(&m_collided_left[i]);
+        f right      = Lanes::load(&m_collided_right[i]);
+
+        velocity_x = Lanes::add(velocity_x, Lanes::mul(Lanes::load(&m_acceleration_x[i]), dt));
+        velocity_y = Lanes::add(velocity_y, Lanes::mul(Lanes::load(&m_acceleration_y[i]), dt));
+
+        // ————— Y PASS ————— //
+        position_y = Lanes::add(position_y, Lanes::mul(velocity_y, dt));
+        for (int j = 0; j < collider_count; j++) {
+            f collider_x      = Lanes::set(m_collider_x[j]);
+            f collider_y      = Lanes::set(m_collider_y[j]);
+            f collider_width  = Lanes::set(m_collider_width[j]);
+            f collider_height = Lanes::set(m_collider_height[j]);
+
+            f y_distance_raw = Lanes::abs(Lanes::sub(position_y, collider_y));
+            f x_distance = Lanes::sub(Lanes::abs(Lanes::sub(position_x, collider_x)), Lanes::mul(Lanes::add(width, collider_width), half));
+            f y_distance = Lanes::sub(y_distance_raw, Lanes::mul(Lanes::add(height, collider_height), half));
+            f hit = Lanes::bit_and(Lanes::less(x_distance, zero), Lanes::less(y_distance, zero));
+            if (!Lanes::any(hit)) continue;
+
+            collides = Lanes::select(hit, Lanes::set(m_collider_type[j]), collides);
+
+            f y_diff = Lanes::abs(Lanes::sub(Lanes::sub(y_distance_raw, Lanes::mul(height, half)), Lanes::mul(collider_height, half)));
+            f moving_up   = Lanes::bit_and(hit, Lanes::less(zero, velocity_y));
+            f moving_down = Lanes::bit_and(hit, Lanes::less(velocity_y, zero));
+
+            position_y = Lanes::select(moving_up,   Lanes::sub(position_y, y_diff), position_y);
+            position_y = Lanes::select(moving_down, Lanes::add(position_y, y_diff), position_y);
+            velocity_y = Lanes::select(Lanes::bit_or(moving_up, moving_down), zero, velocity_y);
+            top        = Lanes::select(moving_up,   one, top);
+            bottom     = Lanes::select(moving_down, one, bottom);
+        }
+
+        // ————— X PASS ————— //
+        position_x = Lanes::add(position_x, Lanes::mul(velocity_x, dt));
+        for (int j = 0; j < collider_count; j++) {
+            f collider_x      = Lanes::set(m_collider_x[j]);
+            f collider_y      = Lanes::set(m_collider_y[j]);
+            f collider_width  = Lanes::set(m_collider_width[j]);
+            f collider_height = Lanes::set(m_collider_height[j]);
+
+            f x_distance_raw = Lanes::abs(Lanes::sub(position_x, collider_x));
+            f x_distance = Lanes::sub(x_distance_raw, Lanes::mul(Lanes::add(width, collider_width), half));
+            f y_distance = Lanes::sub(Lanes::abs(Lanes::sub(position_y, collider_y)), Lanes::mul(Lanes::add(height, collider_height), half));
+            f hit = Lanes::bit_and(Lanes::less(x_distance, zero), Lanes::less(y_distance, zero));
+            if (!Lanes::any(hit)) continue;
+
+            collides = Lanes::select(hit, Lanes::set(m_collider_type[j]), collides);
+
+            f x_diff = Lanes::abs(Lanes::sub(Lanes::sub(x_distance_raw, Lanes::mul(width, half)), Lanes::mul(collider_width, half)));
+            f moving_right = Lanes::bit_and(hit, Lanes::less(zero, velocity_x));
+            f moving_left  = Lanes::bit_and(hit, Lanes::less(velocity_x, zero));
+
+            position_x = Lanes::select(moving_right, Lanes::sub(position_x, x_diff), position_x);
+            position_x = Lanes::select(moving_left,  Lanes::add(position_x, x_diff), position_x);
+            velocity_x = Lanes::select(Lanes::bit_or(moving_right, moving_left), zero, velocity_x);
+            right      = Lanes::select(moving_right, one, right);
+            left       = Lanes::select(moving_left,  one, left);
+        }
+
+        Lanes::store(&m_position_x[i], position_x);
+        Lanes::store(&m_position_y[i], position_y);
+        Lanes::store(&m_velocity_x[i], velocity_x);
+        Lanes::store(&m_velocity_y[i], velocity_y);
+        Lanes::store(&m_collides[i], collides);
+        Lanes::store(&m_collided_top[i], top);
+        Lanes::store(&m_collided_bottom[i], bottom);
+        Lanes::store(&m_collided_left[i], left);
+        Lanes::store(&m_collided_right[i], right);
+    }
+}
+#endif
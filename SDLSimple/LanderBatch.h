@@ -0,0 +1,66 @@
+#pragma once
+
+// LanderBatch: N independent landers stepped together against one set of static
+// colliders. state is kept as structure-of-arrays so the integrate/collide kernel
+// can work on 8 (AVX2) or 4 (SSE2) landers at a time. every lander gives exactly
+// the same result as Entity::update would on the same collider list (to match
+// step() in LanderCore, pass it delta_time * SIMULATION_SPEED).
+
+#include <vector>
+#include "glm/vec3.hpp"
+#include "Entity.h"
+#include "LanderCore.h"
+
+class LanderBatch
+{
+private:
+    int m_lander_count;
+    int m_padded_count; // rounded up to the SIMD width, the extra lanes are never read back
+
+    // ————— PER-LANDER STATE ————— //
+    std::vector<float> m_position_x,     m_position_y;
+    std::vector<float> m_velocity_x,     m_velocity_y;
+    std::vector<float> m_acceleration_x, m_acceleration_y;
+    std::vector<float> m_width,          m_height;
+
+    // collision results are stored as floats so the kernel can blend them like everything else
+    std::vector<float> m_collides;
+    std::vector<float> m_collided_top,  m_collided_bottom;
+    std::vector<float> m_collided_left, m_collided_right;
+
+    // ————— STATIC COLLIDERS ————— //
+    std::vector<float> m_collider_x,     m_collider_y;
+    std::vector<float> m_collider_width, m_collider_height;
+    std::vector<float> m_collider_type;
+
+    void step_scalar(int begin, int end, float delta_time);
+    void step_simd(int begin, int end, float delta_time);
+
+public:
+    // ————— METHODS ————— //
+    LanderBatch(int lander_count);
+
+    void add_colliders(const Collider* colliders, int collider_count);
+    void clear_colliders();
+
+    // purpose: copy position, velocity, acceleration, size and collision state from an entity
+    void reset(int index, const Entity& lander);
+
+    void apply_input(const LanderInput* inputs);
+    void step(float delta_time);
+
+    // purpose: which kernel step() runs on this build ("AVX2", "SSE2" or "scalar")
+    static const char* simd_path();
+
+    // ————— GETTERS ————— //
+    int            const get_lander_count()         const { return m_lander_count; };
+    int            const get_collider_count()       const { return (int) m_collider_x.size(); };
+    glm::vec3      const get_position(int i)        const { return glm::vec3(m_position_x[i], m_position_y[i], 0.0f); };
+    glm::vec3      const get_velocity(int i)        const { return glm::vec3(m_velocity_x[i], m_velocity_y[i], 0.0f); };
+    glm::vec3      const get_acceleration(int i)    const { return glm::vec3(m_acceleration_x[i], m_acceleration_y[i], 0.0f); };
+    type_of_entity const get_collides(int i)        const { return (type_of_entity) (int) m_collides[i]; };
+    bool           const get_collided_top(int i)    const { return m_collided_top[i]    != 0.0f; };
+    bool           const get_collided_bottom(int i) const { return m_collided_bottom[i] != 0.0f; };
+    bool           const get_collided_left(int i)   const { return m_collided_left[i]   != 0.0f; };
+    bool           const get_collided_right(int i)  const { return m_collided_right[i]  != 0.0f; };
+};
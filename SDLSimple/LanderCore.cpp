@@ -0,0 +1,217 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Deterministic.h"
+#include <cstring>
+#include <vector>
+#include "glm/vec3.hpp"
+#include "Entity.h"
+#include "LanderCore.h"
+
+// ————— LEVEL LAYOUT ————— //
+const glm::vec3 GOOD_PLATFORM_POSITIONS[GOOD_PLATFORM_COUNT] =
+{
+    glm::vec3(3.5f, 1.0f, 0.0f),
+    glm::vec3(4.0f, 1.0f, 0.0f),
+};
+
+const glm::vec3 BAD_PLATFORM_POSITIONS[BAD_PLATFORM_COUNT] =
+{
+    glm::vec3(-2.5f, -3.0f, 0.0f),
+    glm::vec3(-2.7f, -3.0f, 0.0f),
+    glm::vec3( 1.5f,  0.0f, 0.0f),
+    glm::vec3( 1.3f,  0.0f, 0.0f),
+    glm::vec3( 3.0f, -2.0f, 0.0f),
+    glm::vec3( 2.8f, -2.0f, 0.0f),
+    glm::vec3(-1.5f,  0.5f, 0.0f),
+    glm::vec3(-1.3f,  0.5f, 0.0f),
+    glm::vec3(-4.2f, -1.0f, 0.0f),
+    glm::vec3(-4.4f, -1.0f, 0.0f),
+    glm::vec3(-4.6f, -1.0f, 0.0f),
+    glm::vec3( 0.0f,  2.9f, 0.0f),
+    glm::vec3( 0.2f,  2.9f, 0.0f),
+    glm::vec3( 0.4f,  2.9f, 0.0f),
+    glm::vec3(-2.9f, -3.0f, 0.0f),
+    glm::vec3( 2.5f, -2.0f, 0.0f),
+    glm::vec3(-1.7f,  0.5f, 0.0f),
+};
+
+// left, right, top, bottom
+const glm::vec3 WALL_POSITIONS[WALL_COUNT] =
+{
+    glm::vec3(-6.0f,  0.0f, 0.0f),
+    glm::vec3( 6.0f,  0.0f, 0.0f),
+    glm::vec3( 0.0f,  4.5f, 0.0f),
+    glm::vec3( 0.0f, -4.5f, 0.0f),
+};
+
+// purpose: pack every box of one type in the level into a collider group, in the order they were created
+void add_collider_group(GameState& state, type_of_entity type, unsigned int layer)
+{
+    Registry const& level = state.level;
+    std::vector<Collider> colliders;
+
+    for (int i = 0; i < level.boxes.size(); i++) {
+        Box const& box = level.boxes[i];
+        if (box.type != type) continue;
+
+        Transform const& transform = level.transforms.get(level.boxes.entity(i));
+        colliders.push_back(Collider { transform.position, box.width, box.height, box.type });
+    }
+
+    state.world.add_group(colliders.data(), (int) colliders.size(), layer);
+}
+
+void initialise_state(GameState& state)
+{
+    // ————— PLAYER ————— //
+
+    // resetting the player, setting the position, movement, acceleration, and speed
+    state.lander.player = Entity();
+
+    // initialize player on the top right like lunar lander
+    state.lander.player.set_position(glm::vec3(-3.0f, 3.0f, 0.0f));
+    state.lander.player.set_movement(glm::vec3(0.0f));
+    state.lander.player.set_acceleration(glm::vec3(0.0f, ACC_OF_GRAVITY * 0.01, 0.0f));
+    state.lander.player.set_speed(1.0f);
+    state.lander.player.entity_type = PLAYER;
+    state.lander.player.collision_mask = LAYER_BADPLATFORM | LAYER_GOODPLATFORM | LAYER_WALLS;
+
+    // for collision measurements
+    state.lander.player.set_height(0.0f);
+    state.lander.player.set_width(0.4f);
+
+    // ————— PLATFORMS ————— //
+    Registry& level = state.level;
+    level.clear();
+
+    // for each platform, create it, place it, and give it a box of its type and a sprite
+    for (int i = 0; i < BAD_PLATFORM_COUNT; i++) {
+        EntityId platform = level.create();
+        level.transforms.add(platform, Transform { BAD_PLATFORM_POSITIONS[i] });
+        level.boxes.add(platform, Box { 1.0f, 1.0f, BADPLATFORM });
+        level.sprites.add(platform, Sprite { 0 });
+    }
+
+    for (int i = 0; i < GOOD_PLATFORM_COUNT; i++) {
+        EntityId platform = level.create();
+        level.transforms.add(platform, Transform { GOOD_PLATFORM_POSITIONS[i] });
+        level.boxes.add(platform, Box { 1.0f, 1.0f, GOODPLATFORM });
+        level.sprites.add(platform, Sprite { 0 });
+    }
+
+    // ————— WALLS ————— //
+    // left and right walls:
+        // width-> 0.1, height-> level height
+    // top and bottom walls:
+        // width-> level width, height-> 0.1
+    // walls are never drawn, so they don't get a sprite
+    for (int i = 0; i < WALL_COUNT; i++) {
+        EntityId wall = level.create();
+        level.transforms.add(wall, Transform { WALL_POSITIONS[i] });
+        level.boxes.add(wall, i < 2 ? Box { 0.1f, LEVEL_HEIGHT, WALLS } : Box { LEVEL_WIDTH, 0.1f, WALLS });
+    }
+
+    // ————— COLLISION WORLD ————— //
+    state.world.clear();
+    add_collider_group(state, BADPLATFORM, LAYER_BADPLATFORM);
+    add_collider_group(state, GOODPLATFORM, LAYER_GOODPLATFORM);
+    add_collider_group(state, WALLS, LAYER_WALLS);
+
+    // ————— TIMER ————— //
+    state.lander.timer_running = true;
+    state.lander.timer_value   = 0.0f;
+}
+
+void shutdown_state(GameState& state)
+{
+    state.level.clear();
+    state.world.clear();
+}
+
+void snapshot(const GameState& state, LanderState& out)
+{
+    memcpy(&out, &state.lander, sizeof(LanderState));
+}
+
+void restore(GameState& state, const LanderState& saved)
+{
+    memcpy(&state.lander, &saved, sizeof(LanderState));
+}
+
+void step(GameState& state, const LanderInput& input, float delta_time)
+{
+    LanderState& lander = state.lander;
+    Entity*      player = &lander.player;
+
+    // move left, if its not pressed, set x acceleration to 0
+    if (input.left) player->move_left();
+    else            player->set_acceleration_x(0.0f);
+
+    if (input.right) player->move_right();
+
+    // move up, if its not pressed, set y acceleration to the acc_of_gravity to keep it falling
+    if (input.up) player->move_up();
+    else          player->set_acceleration_y(ACC_OF_GRAVITY);
+
+    if (lander.timer_running) lander.timer_value += delta_time;
+
+    // one update against every collidable group
+    player->update(delta_time * SIMULATION_SPEED, state.world);
+
+    // hitting anything ends the run, so stop the clock
+    if (is_finished(state)) lander.timer_running = false;
+}
+
+bool is_finished(const GameState& state)
+{
+    type_of_entity collides = state.lander.player.collides;
+    return collides == GOODPLATFORM || collides == BADPLATFORM || collides == WALLS;
+}
+
+// ————— STATE HASH ————— //
+const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ull,
+                         FNV_PRIME        = 1099511628211ull;
+
+void hash_bytes(unsigned long long& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+void hash_float(unsigned long long& hash, float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    hash_bytes(hash, &bits, sizeof(bits));
+}
+
+unsigned long long state_hash(const GameState& state)
+{
+    unsigned long long hash = FNV_OFFSET_BASIS;
+    const Entity* player = &state.lander.player;
+
+    glm::vec3 vectors[] = { player->get_position(), player->get_velocity(), player->get_acceleration() };
+    for (glm::vec3 const& vector : vectors) {
+        hash_float(hash, vector.x);
+        hash_float(hash, vector.y);
+        hash_float(hash, vector.z);
+    }
+
+    int  collides  = player->collides;
+    bool flags[]   = { player->m_collided_top, player->m_collided_bottom,
+                       player->m_collided_left, player->m_collided_right, state.lander.timer_running };
+    hash_bytes(hash, &collides, sizeof(collides));
+    hash_bytes(hash, flags, sizeof(flags));
+    hash_float(hash, state.lander.timer_value);
+
+    return hash;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// lander_core: the game state and fixed-step simulation, with no SDL or OpenGL.
+// main.cpp is just a frontend on top of this (input -> LanderInput, step(), render);
+// anything headless (CI, batch servers) can link lander_core on its own.
+
+#include <type_traits>
+#include "glm/vec3.hpp"
+#include "Entity.h"
+#include "CollisionWorld.h"
+#include "Registry.h"
+
+// ————— CONSTANTS ————— //
+// bulk runs that want a coarser step than this should turn on
+// state.lander.player.set_continuous_collision(true) so nothing gets tunnelled through
+#define FIXED_TIMESTEP 0.0166666f
+#define ACC_OF_GRAVITY -0.01f
+
+// the game was tuned back when the player got three full updates every tick
+// (one per collider group). it now gets one, over three ticks' worth of time,
+// which keeps the same feel.
+#define SIMULATION_SPEED 3.0f
+
+// count for every collidable entity
+// in this game: bad platforms, good platforms, and walls are collidable entities
+#define BAD_PLATFORM_COUNT 17
+#define GOOD_PLATFORM_COUNT 2
+#define WALL_COUNT 4
+
+// the walls were sized with the viewport size in pixels, keep those numbers
+const float LEVEL_WIDTH  = 640 * 1.5f,
+            LEVEL_HEIGHT = 480 * 1.5f;
+
+// ————— STRUCTS ————— //
+// everything step() changes, in one flat block with no pointers it owns,
+// so cloning a game for search or rollback is a single memcpy
+struct LanderState
+{
+    Entity player;
+
+    // adding a timer to make it seem more like lunar lander :)
+    bool  timer_running;
+    float timer_value;
+};
+
+static_assert(std::is_trivially_copyable<LanderState>::value,
+              "LanderState must stay trivially copyable, snapshot() and restore() memcpy it");
+
+struct GameState
+{
+    LanderState lander;
+
+    // the level: platforms and walls. step() never changes any of it, so it
+    // isn't part of a snapshot
+    Registry level;
+
+    // the level's boxes packed into one collider group per type, so the player is
+    // updated once per step
+    CollisionWorld world;
+};
+
+// what the player is pressing this step
+struct LanderInput
+{
+    bool left  = false;
+    bool right = false;
+    bool up    = false;
+};
+
+// ————— FUNCTIONS ————— //
+
+// purpose: set up the player and timer, lay out the platforms and walls and build the collision world
+void initialise_state(GameState& state);
+
+// purpose: empty the level and the collision world
+void shutdown_state(GameState& state);
+
+// purpose: copy out / copy back everything step() changes, one memcpy each way.
+//          a snapshot can be restored into any GameState with the same level.
+void snapshot(const GameState& state, LanderState& out);
+void restore(GameState& state, const LanderState& saved);
+
+// purpose: advance the simulation by one step of delta_time seconds
+void step(GameState& state, const LanderInput& input, float delta_time);
+
+// purpose: true once the player has hit a platform or a wall
+bool is_finished(const GameState& state);
+
+// purpose: 64-bit FNV-1a hash of everything step() changes (the player's physics
+//          and collision state and the timer), bit for bit. two runs fed the same
+//          inputs should agree on it every tick, see Deterministic.h.
+unsigned long long state_hash(const GameState& state);
@@ -0,0 +1,154 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+// lander_core_tests: a console program that links lander_core on its own and
+// checks what it promises: the same inputs give the same state_hash() every tick,
+// a restored snapshot replays exactly, and RolloutPool's results don't depend on
+// how many threads ran them. prints every failure and exits non-zero if there were any
+
+#include <cstdio>
+#include <vector>
+#include "LanderCore.h"
+#include "RolloutPool.h"
+
+// ————— CONSTANTS ————— //
+const int RUN_STEPS      = 600,
+          REPLAY_STEPS   = 200,
+          EPISODE_COUNT  = 256,
+          SERIAL_CHECKED = 16;
+
+int g_failures = 0;
+
+// purpose: count and report a failed check
+void fail(const char* test, const char* what, int at)
+{
+    std::printf("FAIL %s: %s (at %d)\n", test, what, at);
+    g_failures++;
+}
+
+// purpose: the same presses for the same tick, every run
+LanderInput scripted_input(int tick)
+{
+    LanderInput input;
+    input.up    = (tick / 7) % 3 != 0;
+    input.left  = (tick / 23) % 4 == 1;
+    input.right = (tick / 23) % 4 == 2;
+    return input;
+}
+
+// purpose: a controller for the pool that only looks at the state and the episode
+LanderInput steer(const GameState& state, int episode)
+{
+    LanderInput input;
+    input.up    = state.lander.player.get_velocity().y < -0.01f * (episode % 5);
+    input.left  = episode % 3 == 1;
+    input.right = episode % 3 == 2;
+    return input;
+}
+
+// ————— TESTS ————— //
+// purpose: two games fed the same inputs agree on the hash every tick and finish together
+void test_runs_agree()
+{
+    GameState first, second;
+    initialise_state(first);
+    initialise_state(second);
+
+    for (int tick = 0; tick < RUN_STEPS; tick++) {
+        if (is_finished(first) != is_finished(second)) {
+            fail("runs_agree", "one run finished before the other", tick);
+            break;
+        }
+        if (is_finished(first)) break;
+
+        step(first, scripted_input(tick), FIXED_TIMESTEP);
+        step(second, scripted_input(tick), FIXED_TIMESTEP);
+        if (state_hash(first) != state_hash(second)) {
+            fail("runs_agree", "state_hash differs", tick);
+            break;
+        }
+    }
+
+    shutdown_state(first);
+    shutdown_state(second);
+}
+
+// purpose: restoring a snapshot and feeding the same inputs gives the same hashes again
+void test_restore_replays()
+{
+    GameState state;
+    initialise_state(state);
+
+    LanderState saved;
+    snapshot(state, saved);
+
+    std::vector<unsigned long long> hashes;
+    for (int tick = 0; tick < REPLAY_STEPS && !is_finished(state); tick++) {
+        step(state, scripted_input(tick), FIXED_TIMESTEP);
+        hashes.push_back(state_hash(state));
+    }
+
+    restore(state, saved);
+    for (int tick = 0; tick < (int) hashes.size(); tick++) {
+        step(state, scripted_input(tick), FIXED_TIMESTEP);
+        if (state_hash(state) != hashes[tick]) {
+            fail("restore_replays", "replayed state_hash differs", tick);
+            break;
+        }
+    }
+
+    shutdown_state(state);
+}
+
+// purpose: the pool gives the same results on one thread and on several, and
+//          the same as playing the episode out by hand
+void test_pool_matches_serial()
+{
+    std::vector<EpisodeResult> single = RolloutPool(1).run(EPISODE_COUNT, steer, RUN_STEPS);
+    std::vector<EpisodeResult> many   = RolloutPool(4).run(EPISODE_COUNT, steer, RUN_STEPS);
+
+    for (int episode = 0; episode < EPISODE_COUNT; episode++) {
+        EpisodeResult const& a = single[episode];
+        EpisodeResult const& b = many[episode];
+        if (a.outcome != b.outcome || a.steps != b.steps || a.time != b.time || a.final_hash != b.final_hash) {
+            fail("pool_matches_serial", "1 and 4 threads disagree", episode);
+            return;
+        }
+    }
+
+    GameState state;
+    initialise_state(state);
+    LanderState start;
+    snapshot(state, start);
+
+    for (int episode = 0; episode < SERIAL_CHECKED; episode++) {
+        restore(state, start);
+        int steps = 0;
+        while (!is_finished(state) && steps < RUN_STEPS) {
+            step(state, steer(state, episode), FIXED_TIMESTEP);
+            steps++;
+        }
+
+        if (steps != single[episode].steps || state_hash(state) != single[episode].final_hash) {
+            fail("pool_matches_serial", "pool and a serial run disagree", episode);
+            break;
+        }
+    }
+
+    shutdown_state(state);
+}
+
+int main(int argc, char* argv[])
+{
+    test_runs_agree();
+    test_restore_replays();
+    test_pool_matches_serial();
+
+    if (g_failures == 0) std::printf("lander_core: all checks passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
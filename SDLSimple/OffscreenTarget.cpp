@@ -0,0 +1,115 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <cstring>
+#include "OffscreenTarget.h"
+
+// long enough for any frame, a sink that waits on a frame wants it regardless
+const GLuint64 FENCE_TIMEOUT = 1000000000ull; // nanoseconds
+
+bool OffscreenTarget::is_supported()
+{
+    const char* extensions = (const char*) glGetString(GL_EXTENSIONS);
+    return extensions != NULL &&
+           strstr(extensions, "GL_ARB_framebuffer_object")  != NULL &&
+           strstr(extensions, "GL_ARB_pixel_buffer_object") != NULL &&
+           strstr(extensions, "GL_ARB_sync")                != NULL;
+}
+
+void OffscreenTarget::initialise(int width, int height, FrameSink sink)
+{
+    m_width  = width;
+    m_height = height;
+    m_sink   = sink;
+
+    glGenRenderbuffers(1, &m_colour_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colour_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colour_buffer);
+
+    glGenBuffers(RING_SIZE, m_pixel_buffers);
+    for (int i = 0; i < RING_SIZE; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, m_width * m_height * 4, NULL, GL_STREAM_READ);
+        m_fences[i] = 0;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // rows of RGBA8 are always 4-byte aligned, but say so
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+}
+
+void OffscreenTarget::shutdown()
+{
+    while (m_pending > 0) finish_oldest(true);
+
+    glDeleteBuffers(RING_SIZE, m_pixel_buffers);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_colour_buffer);
+    m_framebuffer   = 0;
+    m_colour_buffer = 0;
+}
+
+void OffscreenTarget::bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+void OffscreenTarget::capture()
+{
+    // hand over whatever has finished since last time, oldest first
+    while (m_pending > 0 && finish_oldest(false)) {}
+
+    // the ring is full: this is the only place capture waits
+    if (m_pending == RING_SIZE) finish_oldest(true);
+
+    int slot = (m_oldest + m_pending) % RING_SIZE;
+
+    // with a pack buffer bound, glReadPixels just queues a copy into it and returns
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[slot]);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, (void*) 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_frames[slot] = m_captured++;
+    m_pending++;
+
+    // make sure the fence actually gets to the GPU, or a later wait on it could hang
+    glFlush();
+}
+
+bool OffscreenTarget::finish_oldest(bool wait)
+{
+    int slot = m_oldest;
+
+    GLenum status = glClientWaitSync(m_fences[slot], 0, wait ? FENCE_TIMEOUT : 0);
+    if (status == GL_TIMEOUT_EXPIRED && !wait) return false;
+
+    glDeleteSync(m_fences[slot]);
+    m_fences[slot] = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[slot]);
+    const unsigned char* pixels = (const unsigned char*) glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels != NULL) {
+        if (m_sink) m_sink(pixels, m_width, m_height, m_frames[slot]);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_oldest = (m_oldest + 1) % RING_SIZE;
+    m_pending--;
+    return true;
+}
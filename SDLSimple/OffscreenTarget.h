@@ -0,0 +1,64 @@
+#pragma once
+
+// OffscreenTarget: a framebuffer object to render into when there's no window
+// to show frames in, plus a ring of pixel buffer objects to read them back
+// through. capture() only queues a glReadPixels into the next buffer of the
+// ring and fences it; the pixels are handed to the sink a few frames later,
+// once the GPU is done with them, so reading frames back never stalls drawing
+// unless the sink falls a whole ring behind.
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <functional>
+
+// gets every captured frame in order: RGBA, bottom row first, only valid during the call
+typedef std::function<void(const unsigned char* pixels, int width, int height, unsigned int frame)> FrameSink;
+
+class OffscreenTarget
+{
+private:
+    static const int RING_SIZE = 4;
+
+    int m_width  = 0;
+    int m_height = 0;
+
+    GLuint m_framebuffer   = 0;
+    GLuint m_colour_buffer = 0;
+
+    // slot i holds frame m_frames[i] until its fence has passed and it's been handed over
+    GLuint       m_pixel_buffers[RING_SIZE];
+    GLsync       m_fences[RING_SIZE];
+    unsigned int m_frames[RING_SIZE];
+    int          m_oldest  = 0;
+    int          m_pending = 0;
+
+    unsigned int m_captured = 0;
+    FrameSink    m_sink;
+
+    // purpose: hand the oldest pending frame to the sink, waiting for it if wait is set.
+    //          false if it isn't ready and wait isn't set
+    bool finish_oldest(bool wait);
+
+public:
+    // ————— METHODS ————— //
+    static bool is_supported();
+
+    void initialise(int width, int height, FrameSink sink);
+
+    // purpose: deliver every frame still in flight, then free the GL objects
+    void shutdown();
+
+    // purpose: draw into the target from here on
+    void bind();
+
+    // purpose: queue a readback of what's been drawn, and deliver any earlier frames that are ready
+    void capture();
+
+    // ————— GETTERS ————— //
+    int          const get_width()    const { return m_width; };
+    int          const get_height()   const { return m_height; };
+    unsigned int const get_captured() const { return m_captured; };
+};
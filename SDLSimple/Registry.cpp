@@ -0,0 +1,43 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Deterministic.h"
+#include "Registry.h"
+
+EntityId Registry::create()
+{
+    if (!m_free_ids.empty()) {
+        EntityId id = m_free_ids.back();
+        m_free_ids.pop_back();
+        m_live[id] = true;
+        return id;
+    }
+    m_live.push_back(true);
+    return m_next_id++;
+}
+
+void Registry::destroy(EntityId id)
+{
+    if (!is_live(id)) return;
+    m_live[id] = false;
+
+    transforms.remove(id);
+    boxes.remove(id);
+    sprites.remove(id);
+    m_free_ids.push_back(id);
+}
+
+void Registry::clear()
+{
+    transforms.clear();
+    boxes.clear();
+    sprites.clear();
+    m_next_id = 0;
+    m_free_ids.clear();
+    m_live.clear();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+// Registry: the level's entities, stored as sparse sets of components.
+// an entity is only an id. every component type has its own pool that keeps its
+// values packed in one dense array, so a system walks just the components it
+// reads: collision packs Transform + Box into Colliders, rendering draws
+// Transform + Sprite. the player is still an Entity, since it's the one body
+// step() moves and all of it has to sit in LanderState for snapshot().
+
+#include <vector>
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "Entity.h"
+
+typedef unsigned int EntityId;
+
+// ————— COMPONENTS ————— //
+struct Transform
+{
+    glm::vec3 position;
+};
+
+// collision box
+struct Box
+{
+    float          width;
+    float          height;
+    type_of_entity type;
+};
+
+struct Sprite
+{
+    unsigned int texture_id; // GLuint, handed out by the frontend
+    glm::vec4    uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); // (u0, v0, u1, v1), v0 at the top
+};
+
+// ————— STORAGE ————— //
+template <typename T>
+class ComponentPool
+{
+private:
+    enum { ABSENT = -1 };
+
+    std::vector<int>      m_sparse;   // entity id -> slot in m_dense, ABSENT if it has no T
+    std::vector<EntityId> m_entities; // which entity owns each slot
+    std::vector<T>        m_dense;
+
+public:
+    // ————— METHODS ————— //
+    void add(EntityId id, T const& component)
+    {
+        if (id >= m_sparse.size()) m_sparse.resize(id + 1, (int) ABSENT);
+        if (m_sparse[id] != ABSENT) {
+            m_dense[m_sparse[id]] = component;
+            return;
+        }
+        m_sparse[id] = (int) m_dense.size();
+        m_entities.push_back(id);
+        m_dense.push_back(component);
+    }
+
+    // purpose: move the last slot into the hole so the array stays packed
+    void remove(EntityId id)
+    {
+        if (!has(id)) return;
+
+        int slot = m_sparse[id];
+        m_dense[slot]    = m_dense.back();
+        m_entities[slot] = m_entities.back();
+        m_sparse[m_entities[slot]] = slot;
+
+        m_dense.pop_back();
+        m_entities.pop_back();
+        m_sparse[id] = ABSENT;
+    }
+
+    void clear()
+    {
+        m_sparse.clear();
+        m_entities.clear();
+        m_dense.clear();
+    }
+
+    bool has(EntityId id) const { return id < m_sparse.size() && m_sparse[id] != ABSENT; };
+
+    // ————— GETTERS ————— //
+    // by entity id
+    T&       get(EntityId id)       { return m_dense[m_sparse[id]]; };
+    T const& get(EntityId id) const { return m_dense[m_sparse[id]]; };
+
+    // by slot, for walking the dense array
+    int      const size()              const { return (int) m_dense.size(); };
+    EntityId const entity(int slot)    const { return m_entities[slot]; };
+    T&             operator[](int slot)       { return m_dense[slot]; };
+    T const&       operator[](int slot) const { return m_dense[slot]; };
+};
+
+class Registry
+{
+private:
+    EntityId              m_next_id = 0;
+    std::vector<EntityId> m_free_ids;
+    std::vector<bool>     m_live;     // by id: created and not destroyed since
+
+public:
+    // ————— POOLS ————— //
+    ComponentPool<Transform> transforms;
+    ComponentPool<Box>       boxes;
+    ComponentPool<Sprite>    sprites;
+
+    // ————— METHODS ————— //
+    EntityId create();
+
+    // purpose: drop every component of id and recycle it. an id that isn't live is
+    //          left alone, so destroying twice can't hand it out twice
+    void destroy(EntityId id);
+    void clear();
+
+    // ————— GETTERS ————— //
+    int  const get_entity_count()    const { return (int) (m_next_id - m_free_ids.size()); };
+    bool const is_live(EntityId id) const { return id < m_live.size() && m_live[id]; };
+};
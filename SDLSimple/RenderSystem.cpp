@@ -0,0 +1,26 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Registry.h"
+#include "SpriteBatch.h"
+#include "InstancedSpriteBatch.h"
+#include "RenderSystem.h"
+
+// both batches take the same draw() calls
+template <typename Batch>
+void queue_sprites(Batch& batch, const Registry& registry)
+{
+    for (int i = 0; i < registry.sprites.size(); i++) {
+        Transform const& transform = registry.transforms.get(registry.sprites.entity(i));
+        Sprite const&    sprite    = registry.sprites[i];
+        batch.draw(sprite.texture_id, transform.position, glm::vec2(1.0f), sprite.uv_rect);
+    }
+}
+
+void render_sprites(SpriteBatch& batch, const Registry& registry)          { queue_sprites(batch, registry); }
+void render_sprites(InstancedSpriteBatch& batch, const Registry& registry) { queue_sprites(batch, registry); }
@@ -0,0 +1,12 @@
+#pragma once
+
+// rendering systems: walk the Registry's dense component arrays, touching only
+// what a draw needs (Transform + Sprite), and hand the quads to a sprite batch
+
+#include "SpriteBatch.h"
+#include "InstancedSpriteBatch.h"
+#include "Registry.h"
+
+// purpose: queue every entity that has a sprite as a unit quad at its position
+void render_sprites(SpriteBatch& batch, const Registry& registry);
+void render_sprites(InstancedSpriteBatch& batch, const Registry& registry);
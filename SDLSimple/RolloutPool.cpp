@@ -0,0 +1,129 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Deterministic.h"
+#include <thread>
+#include "RolloutPool.h"
+
+// ————— WORK RANGES ————— //
+unsigned long long pack_range(unsigned int begin, unsigned int end)
+{
+    return ((unsigned long long) end << 32) | begin;
+}
+
+unsigned int range_begin(unsigned long long range) { return (unsigned int) range; }
+unsigned int range_end(unsigned long long range)   { return (unsigned int) (range >> 32); }
+
+RolloutPool::RolloutPool(int thread_count)
+{
+    if (thread_count <= 0) thread_count = (int) std::thread::hardware_concurrency();
+    if (thread_count <= 0) thread_count = 1;
+    m_thread_count = thread_count;
+}
+
+// purpose: pop the next episode off the front of a worker's own run
+bool RolloutPool::take(WorkRange& own, int& episode)
+{
+    unsigned long long range = own.range.load();
+    while (range_begin(range) < range_end(range)) {
+        unsigned long long taken = pack_range(range_begin(range) + 1, range_end(range));
+        if (own.range.compare_exchange_weak(range, taken)) {
+            episode = (int) range_begin(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+// purpose: move the back half of the biggest run left to the thief's (empty) run
+bool RolloutPool::steal(std::vector<WorkRange>& ranges, int thief)
+{
+    while (true) {
+        int victim = -1;
+        unsigned int most = 0;
+        unsigned long long victim_range = 0;
+
+        for (int i = 0; i < (int) ranges.size(); i++) {
+            if (i == thief) continue;
+            unsigned long long range = ranges[i].range.load();
+            unsigned int left = range_end(range) - range_begin(range);
+            if (range_begin(range) < range_end(range) && left > most) {
+                victim = i;
+                most = left;
+                victim_range = range;
+            }
+        }
+        if (victim < 0) return false;
+
+        unsigned int middle = range_end(victim_range) - (most + 1) / 2;
+        unsigned long long kept = pack_range(range_begin(victim_range), middle);
+        if (ranges[victim].range.compare_exchange_strong(victim_range, kept)) {
+            // nobody steals from an empty run, so a plain store is enough here
+            ranges[thief].range.store(pack_range(middle, range_end(victim_range)));
+            return true;
+        }
+        // the victim took or lost work in the meantime, look again
+    }
+}
+
+std::vector<EpisodeResult> RolloutPool::run(int episode_count, Controller controller,
+                                            int max_steps, float delta_time)
+{
+    std::vector<EpisodeResult> results(episode_count);
+    std::vector<WorkRange> ranges(m_thread_count);
+
+    // deal the episodes out in contiguous runs
+    for (int i = 0; i < m_thread_count; i++) {
+        unsigned int begin = (unsigned int) ((long long) episode_count * i / m_thread_count);
+        unsigned int end   = (unsigned int) ((long long) episode_count * (i + 1) / m_thread_count);
+        ranges[i].range.store(pack_range(begin, end));
+    }
+
+    auto worker = [&](int index)
+    {
+        // each worker lays its level out once, and every episode starts from a
+        // snapshot of the fresh state instead of allocating a new one
+        GameState state;
+        initialise_state(state);
+
+        LanderState start;
+        snapshot(state, start);
+
+        int episode;
+        while (true) {
+            if (!take(ranges[index], episode)) {
+                if (steal(ranges, index)) continue;
+                break;
+            }
+
+            restore(state, start);
+
+            int steps = 0;
+            while (!is_finished(state) && steps < max_steps) {
+                step(state, controller(state, episode), delta_time);
+                steps++;
+            }
+
+            EpisodeResult& result = results[episode];
+            result.outcome    = state.lander.player.collides;
+            result.steps      = steps;
+            result.time       = state.lander.timer_value;
+            result.final_hash = state_hash(state);
+        }
+
+        shutdown_state(state);
+    };
+
+    // the calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < m_thread_count; i++) threads.push_back(std::thread(worker, i));
+    worker(0);
+    for (std::thread& thread : threads) thread.join();
+
+    return results;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// RolloutPool: runs many independent episodes of the game across every core.
+// each worker lays out one GameState and restores it from a snapshot for every
+// episode. episodes are dealt out to the workers in contiguous runs, and a worker
+// that runs dry steals half of what's left from another worker's run. both ends
+// of a run live in one atomic word, so handing out and stealing work never takes
+// a lock, and every result goes straight into its own slot of the output vector.
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "Entity.h"
+#include "LanderCore.h"
+
+// picks the input for the next step of episode `episode`, called from many threads at once
+typedef std::function<LanderInput(const GameState& state, int episode)> Controller;
+
+struct EpisodeResult
+{
+    type_of_entity     outcome;    // what the player hit, PLAYER if it ran out of steps
+    int                steps;
+    float              time;       // the in-game timer when the episode ended
+    unsigned long long final_hash; // state_hash() of the last state
+};
+
+class RolloutPool
+{
+private:
+    int m_thread_count;
+
+    static const int CACHE_LINE = 64;
+
+    // one run of episode indices per worker: begin in the low 32 bits, end in the high 32 bits.
+    // padded out to a whole cache line, so no two workers' ranges ever share one. (not
+    // alignas: std::allocator before C++17 doesn't honour it, and they live in a vector)
+    struct WorkRange
+    {
+        std::atomic<unsigned long long> range;
+        char padding[CACHE_LINE - sizeof(std::atomic<unsigned long long>)];
+    };
+
+    bool take(WorkRange& own, int& episode);
+    bool steal(std::vector<WorkRange>& ranges, int thief);
+
+public:
+    // ————— METHODS ————— //
+    RolloutPool(int thread_count = 0); // 0 means one per hardware thread
+
+    // purpose: run episode_count episodes of at most max_steps steps of delta_time
+    //          each, results are indexed by episode
+    std::vector<EpisodeResult> run(int episode_count, Controller controller,
+                                   int max_steps, float delta_time = FIXED_TIMESTEP);
+
+    // ————— GETTERS ————— //
+    int const get_thread_count() const { return m_thread_count; };
+};
@@ -2,6 +2,11 @@
 
 #include "ShaderProgram.h"
 
+GLuint ShaderProgram::s_current_program = 0;
+GLuint ShaderProgram::s_bound_texture   = 0;
+bool   ShaderProgram::s_attribute_enabled[MAX_TRACKED_ATTRIBUTES] = {};
+int    ShaderProgram::s_skipped_calls   = 0;
+
 void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_shader_file) {
     
     // create the vertex shader
@@ -13,7 +18,10 @@ void ShaderProgram::load(const char *vertex_shader_file, const char *fragment_sh
     m_program_id = glCreateProgram();
     glAttachShader(m_program_id, m_vertex_shader);
     glAttachShader(m_program_id, m_fragment_shader);
+    glBindAttribLocation(m_program_id, POSITION_ATTRIBUTE_SLOT, "position");
+    glBindAttribLocation(m_program_id, TEX_COORD_ATTRIBUTE_SLOT, "texCoord");
     glLinkProgram(m_program_id);
+    forget_uniforms();
     
     GLint link_success;
     glGetProgramiv(m_program_id, GL_LINK_STATUS, &link_success);
@@ -90,24 +98,113 @@ GLuint ShaderProgram::load_shader_from_string(const std::string &shaderContents,
 
 void ShaderProgram::set_colour(float red, float green, float blue, float alpha)
 {
-    glUseProgram(m_program_id);
+    use();
+    glm::vec4 colour(red, green, blue, alpha);
+    if (m_colour_set && m_colour == colour) {
+        s_skipped_calls++;
+        return;
+    }
     glUniform4f(m_colour_uniform, red, green, blue, alpha);
+    m_colour     = colour;
+    m_colour_set = true;
 }
 
 void ShaderProgram::set_view_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
+    use();
+    if (m_view_matrix_set && m_view_matrix == matrix) {
+        s_skipped_calls++;
+        return;
+    }
     glUniformMatrix4fv(m_view_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    m_view_matrix     = matrix;
+    m_view_matrix_set = true;
 }
 
 void ShaderProgram::set_model_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
+    use();
+    if (m_model_matrix_set && m_model_matrix == matrix) {
+        s_skipped_calls++;
+        return;
+    }
     glUniformMatrix4fv(m_model_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    m_model_matrix     = matrix;
+    m_model_matrix_set = true;
 }
 
 void ShaderProgram::set_projection_matrix(const glm::mat4 &matrix)
 {
-    glUseProgram(m_program_id);
+    use();
+    if (m_projection_matrix_set && m_projection_matrix == matrix) {
+        s_skipped_calls++;
+        return;
+    }
     glUniformMatrix4fv(m_projection_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    m_projection_matrix     = matrix;
+    m_projection_matrix_set = true;
+}
+
+// ————— STATE TRACKING ————— //
+// purpose: a freshly linked (or swapped in) program has none of our uniform values
+void ShaderProgram::forget_uniforms()
+{
+    m_model_matrix_set      = false;
+    m_view_matrix_set       = false;
+    m_projection_matrix_set = false;
+    m_colour_set            = false;
+}
+
+void ShaderProgram::use()
+{
+    if (s_current_program == m_program_id) {
+        s_skipped_calls++;
+        return;
+    }
+    glUseProgram(m_program_id);
+    s_current_program = m_program_id;
+}
+
+void ShaderProgram::bind_texture(GLuint texture_id)
+{
+    if (s_bound_texture == texture_id) {
+        s_skipped_calls++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    s_bound_texture = texture_id;
+}
+
+void ShaderProgram::delete_texture(GLuint texture_id)
+{
+    glDeleteTextures(1, &texture_id);
+    if (s_bound_texture == texture_id) s_bound_texture = 0;
+}
+
+void ShaderProgram::enable_attribute(GLuint attribute)
+{
+    if (attribute >= MAX_TRACKED_ATTRIBUTES) {
+        glEnableVertexAttribArray(attribute);
+        return;
+    }
+    if (s_attribute_enabled[attribute]) {
+        s_skipped_calls++;
+        return;
+    }
+    glEnableVertexAttribArray(attribute);
+    s_attribute_enabled[attribute] = true;
+}
+
+void ShaderProgram::disable_attribute(GLuint attribute)
+{
+    if (attribute >= MAX_TRACKED_ATTRIBUTES) {
+        glDisableVertexAttribArray(attribute);
+        return;
+    }
+    if (!s_attribute_enabled[attribute]) {
+        s_skipped_calls++;
+        return;
+    }
+    glDisableVertexAttribArray(attribute);
+    s_attribute_enabled[attribute] = false;
 }
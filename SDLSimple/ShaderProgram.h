@@ -10,6 +10,15 @@
 #include <fstream>
 #include <sstream>
 #include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+// every program links position and texCoord to these slots, so the arrays that
+// feed them can stay enabled from one program to the next
+#define POSITION_ATTRIBUTE_SLOT 0
+#define TEX_COORD_ATTRIBUTE_SLOT 1
+
+// attribute slots whose enabled state is shadowed (the GL minimum for GL_MAX_VERTEX_ATTRIBS)
+#define MAX_TRACKED_ATTRIBUTES 16
 
 class ShaderProgram
 {
@@ -31,6 +40,26 @@ private:
 
     GLuint m_vertex_shader;
     GLuint m_fragment_shader;
+
+    // ————— STATE TRACKING ————— //
+    // the last values uploaded to this program's uniforms
+    glm::mat4 m_model_matrix,
+              m_view_matrix,
+              m_projection_matrix;
+    glm::vec4 m_colour;
+
+    bool m_model_matrix_set      = false,
+         m_view_matrix_set       = false,
+         m_projection_matrix_set = false,
+         m_colour_set            = false;
+
+    // there's one GL context, so what it has bound is shared by every program
+    static GLuint s_current_program;
+    static GLuint s_bound_texture;
+    static bool   s_attribute_enabled[MAX_TRACKED_ATTRIBUTES];
+    static int    s_skipped_calls;
+
+    void forget_uniforms();
     
 public:
 
@@ -45,5 +74,17 @@ public:
     GLuint const get_position_attribute()       const { return m_position_attribute;  };
     GLuint const get_tex_coordinate_attribute() const { return m_tex_coord_attribute; };
     
-    void set_program_id(GLuint program_id)                         { m_program_id = program_id;                   };
+    void set_program_id(GLuint program_id)                         { m_program_id = program_id; forget_uniforms(); };
+
+    // ————— STATE TRACKING ————— //
+    // all program, texture and attribute-array changes go through these, which
+    // skip (and count) any call that wouldn't change what's already bound
+    void use();
+    static void bind_texture(GLuint texture_id);
+    static void delete_texture(GLuint texture_id); // GL unbinds it, and the id can come back from glGenTextures
+    static void enable_attribute(GLuint attribute);
+    static void disable_attribute(GLuint attribute);
+
+    static int  const get_skipped_calls()   { return s_skipped_calls; };
+    static void       reset_skipped_calls() { s_skipped_calls = 0; };
 };
@@ -0,0 +1,75 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#include "Deterministic.h"
+#include <algorithm>
+#include <cmath>
+#include "SpatialHash.h"
+
+SpatialHash::SpatialHash(float cell_size)
+{
+    m_cell_size = cell_size;
+}
+
+glm::ivec2 SpatialHash::cell_of(float x, float y) const
+{
+    return glm::ivec2((int) std::floor(x / m_cell_size), (int) std::floor(y / m_cell_size));
+}
+
+void SpatialHash::build(const Collider* colliders, int collider_count)
+{
+    m_cells.clear();
+    m_oversized.clear();
+
+    for (int i = 0; i < collider_count; i++) {
+        glm::vec3 position = colliders[i].position;
+        float half_width   = colliders[i].width  / 2.0f;
+        float half_height  = colliders[i].height / 2.0f;
+
+        if (colliders[i].width > m_cell_size || colliders[i].height > m_cell_size) {
+            m_oversized.push_back(i);
+            continue;
+        }
+
+        glm::ivec2 low  = cell_of(position.x - half_width, position.y - half_height);
+        glm::ivec2 high = cell_of(position.x + half_width, position.y + half_height);
+
+        for (int x = low.x; x <= high.x; x++) {
+            for (int y = low.y; y <= high.y; y++) {
+                m_cells[glm::ivec2(x, y)].push_back(i);
+            }
+        }
+    }
+}
+
+void SpatialHash::query(glm::vec3 centre, float width, float height, std::vector<int>& candidates) const
+{
+    candidates.assign(m_oversized.begin(), m_oversized.end());
+
+    // hashed colliders are at most one cell across, so resolving against one of them
+    // pushes the box by at most half its own size plus half a cell. reaching a full
+    // box size plus a cell out from the centre keeps whatever the pushed box could
+    // still overlap in the result.
+    float reach_x = width  + m_cell_size;
+    float reach_y = height + m_cell_size;
+
+    glm::ivec2 low  = cell_of(centre.x - reach_x, centre.y - reach_y);
+    glm::ivec2 high = cell_of(centre.x + reach_x, centre.y + reach_y);
+
+    for (int x = low.x; x <= high.x; x++) {
+        for (int y = low.y; y <= high.y; y++) {
+            std::unordered_map<glm::ivec2, std::vector<int> >::const_iterator cell = m_cells.find(glm::ivec2(x, y));
+            if (cell == m_cells.end()) continue;
+            candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+        }
+    }
+
+    // a collider that spans several cells shows up once per cell
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
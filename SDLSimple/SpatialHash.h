@@ -0,0 +1,40 @@
+#pragma once
+
+// SpatialHash: uniform-grid broadphase over a group of static colliders.
+// each collider is filed under every cell its box touches, cells are keyed by
+// their integer coordinates (hashed with glm/gtx/hash.hpp). colliders bigger than
+// a cell (like the walls) go on a short list that every query returns.
+
+#include <vector>
+#include <unordered_map>
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/gtx/hash.hpp"
+#include "Entity.h"
+
+class SpatialHash
+{
+private:
+    float m_cell_size;
+
+    std::unordered_map<glm::ivec2, std::vector<int> > m_cells;
+    std::vector<int> m_oversized;
+
+    glm::ivec2 cell_of(float x, float y) const;
+
+public:
+    // ————— METHODS ————— //
+    SpatialHash(float cell_size = 1.0f);
+
+    void build(const Collider* colliders, int collider_count);
+
+    // purpose: every collider that could touch a box of the given size at centre,
+    //          even after the box is pushed out of one of them. results are sorted
+    //          by index so callers resolve in the same order as a linear scan.
+    void query(glm::vec3 centre, float width, float height, std::vector<int>& candidates) const;
+
+    // ————— GETTERS ————— //
+    float const get_cell_size()  const { return m_cell_size; };
+    int   const get_cell_count() const { return (int) m_cells.size(); };
+};
@@ -0,0 +1,144 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "glm/mat4x4.hpp"
+#include "SpriteBatch.h"
+
+void SpriteBatch::initialise(StreamBuffer* stream)
+{
+    m_stream = stream;
+    if (m_stream == NULL) glGenBuffers(1, &m_vertex_buffer);
+}
+
+void SpriteBatch::shutdown()
+{
+    if (m_vertex_buffer != 0) glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_buffer = 0;
+    m_stream        = NULL;
+}
+
+void SpriteBatch::begin()
+{
+    m_quads.clear();
+    m_quad_textures.clear();
+}
+
+void SpriteBatch::draw(GLuint texture_id, glm::vec3 position, glm::vec2 size, glm::vec4 uv_rect)
+{
+    float left   = position.x - size.x / 2.0f,
+          right  = position.x + size.x / 2.0f,
+          bottom = position.y - size.y / 2.0f,
+          top    = position.y + size.y / 2.0f;
+
+    float u0 = uv_rect.x, v0 = uv_rect.y,
+          u1 = uv_rect.z, v1 = uv_rect.w;
+
+    // same two triangles, in the same order, as Entity::render
+    m_quads.insert(m_quads.end(), {
+        left,  bottom, u0, v1,
+        right, bottom, u1, v1,
+        right, top,    u1, v0,
+        left,  bottom, u0, v1,
+        right, top,    u1, v0,
+        left,  top,    u0, v0,
+    });
+    m_quad_textures.push_back(texture_id);
+}
+
+void SpriteBatch::end(ShaderProgram* program)
+{
+    if (m_stream != NULL) upload(*m_stream);
+    else                  upload(GL_STREAM_DRAW);
+    render(program);
+}
+
+bool SpriteBatch::build_runs()
+{
+    int quad_count = get_quad_count();
+    m_runs.clear();
+    m_uploaded_quads = quad_count;
+    if (quad_count == 0) return false;
+
+    // group the quads by texture, keeping submission order inside each group
+    m_order.resize(quad_count);
+    for (int i = 0; i < quad_count; i++) m_order[i] = i;
+    std::stable_sort(m_order.begin(), m_order.end(),
+                     [this](int a, int b) { return m_quad_textures[a] < m_quad_textures[b]; });
+
+    m_vertices.resize(m_quads.size());
+    for (int i = 0; i < quad_count; i++) {
+        std::copy(m_quads.begin() + m_order[i] * FLOATS_PER_QUAD,
+                  m_quads.begin() + (m_order[i] + 1) * FLOATS_PER_QUAD,
+                  m_vertices.begin() + i * FLOATS_PER_QUAD);
+    }
+
+    // one run of quads per texture
+    int first = 0;
+    while (first < quad_count) {
+        GLuint texture_id = m_quad_textures[m_order[first]];
+        int last = first + 1;
+        while (last < quad_count && m_quad_textures[m_order[last]] == texture_id) last++;
+
+        Run run = { texture_id, first, last - first };
+        m_runs.push_back(run);
+        first = last;
+    }
+
+    return true;
+}
+
+void SpriteBatch::upload(GLenum usage)
+{
+    if (!build_runs()) return;
+
+    // orphan the old storage so the driver doesn't wait on draws still reading it
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), NULL, usage);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(float), m_vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_draw_buffer = m_vertex_buffer;
+    m_draw_offset = 0;
+}
+
+void SpriteBatch::upload(StreamBuffer& stream)
+{
+    if (!build_runs()) return;
+
+    m_draw_offset = stream.write(m_vertices.data(), m_vertices.size() * sizeof(float));
+    m_draw_buffer = stream.get_buffer();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SpriteBatch::render(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    if (m_runs.empty()) return;
+
+    // positions are already in world space
+    program->set_model_matrix(glm::mat4(1.0f));
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_draw_buffer);
+
+    GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (void*) m_draw_offset);
+    ShaderProgram::enable_attribute(program->get_position_attribute());
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride, (void*) (m_draw_offset + 2 * sizeof(float)));
+    ShaderProgram::enable_attribute(program->get_tex_coordinate_attribute());
+
+    for (Run const& run : m_runs) {
+        ShaderProgram::bind_texture(run.texture_id);
+        glDrawArrays(GL_TRIANGLES, run.first * VERTICES_PER_QUAD, run.count * VERTICES_PER_QUAD);
+        m_draw_calls++;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// SpriteBatch: collects textured quads for a frame and draws them with one
+// glDrawArrays per texture. quads are transformed on the CPU and streamed into a
+// single vertex buffer, so draw calls only grow with the number of textures,
+// not the number of sprites. quads sharing a texture keep the order they were
+// submitted in; across textures, lower texture ids draw first.
+//
+// for geometry that never moves, fill the batch once, upload() it with
+// GL_STATIC_DRAW and just render() it every frame: the buffer is kept until the
+// next upload(), so the per-frame cost is the draw calls alone. a batch that's
+// refilled every frame should be given a StreamBuffer instead, and end() will
+// append its vertices there rather than respecifying a buffer of its own.
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "ShaderProgram.h"
+#include "StreamBuffer.h"
+
+class SpriteBatch
+{
+private:
+    // x, y, u, v for each of a quad's 6 vertices
+    static const int FLOATS_PER_VERTEX = 4,
+                     VERTICES_PER_QUAD = 6,
+                     FLOATS_PER_QUAD   = FLOATS_PER_VERTEX * VERTICES_PER_QUAD;
+
+    GLuint        m_vertex_buffer = 0; // only made when there's no stream
+    StreamBuffer* m_stream        = NULL;
+
+    // where the last upload() put its vertices
+    GLuint   m_draw_buffer = 0;
+    GLintptr m_draw_offset = 0;
+
+    // this frame's quads, in submission order, and the texture each one uses
+    std::vector<float>  m_quads;
+    std::vector<GLuint> m_quad_textures;
+
+    // reused every frame so end() doesn't allocate once the batch has warmed up
+    std::vector<int>   m_order;
+    std::vector<float> m_vertices;
+
+    // what the last upload() put in the buffer: quads [first, first + count) use texture_id
+    struct Run
+    {
+        GLuint texture_id;
+        int    first;
+        int    count;
+    };
+    std::vector<Run> m_runs;
+    int m_uploaded_quads = 0;
+
+    // purpose: sort this frame's quads by texture into m_vertices and m_runs,
+    //          returns false if there's nothing to upload
+    bool build_runs();
+
+    int m_draw_calls = 0;
+
+public:
+    // ————— METHODS ————— //
+    // purpose: with a stream, end() writes into it; without, the batch gets its own buffer
+    void initialise(StreamBuffer* stream = NULL);
+    void shutdown();
+
+    void begin();
+
+    // purpose: queue a quad of size centred on position. uv_rect is (u0, v0, u1, v1)
+    //          with v0 at the top, so the default is the whole texture
+    void draw(GLuint texture_id, glm::vec3 position, glm::vec2 size = glm::vec2(1.0f),
+              glm::vec4 uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+
+    // purpose: upload everything queued since begin() and draw it, one call per texture
+    void end(ShaderProgram* program);
+
+    // purpose: end() in two halves, for batches that are uploaded once and drawn many times
+    void upload(GLenum usage);
+    void upload(StreamBuffer& stream);
+    void render(ShaderProgram* program);
+
+    // ————— GETTERS ————— //
+    int const get_quad_count()  const { return (int) m_quad_textures.size(); };
+    int const get_uploaded_quad_count() const { return m_uploaded_quads; };
+    int const get_draw_calls()  const { return m_draw_calls; }; // issued by the last end()
+};
@@ -0,0 +1,84 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstring>
+#include "StreamBuffer.h"
+
+bool StreamBuffer::is_supported()
+{
+    const char* extensions = (const char*) glGetString(GL_EXTENSIONS);
+    return extensions != NULL && strstr(extensions, "GL_ARB_map_buffer_range") != NULL;
+}
+
+void StreamBuffer::initialise(GLsizeiptr capacity)
+{
+    m_capacity  = capacity;
+    m_map_range = is_supported();
+
+    glGenBuffers(1, &m_buffer);
+    orphan();
+}
+
+void StreamBuffer::shutdown()
+{
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer   = 0;
+    m_capacity = 0;
+}
+
+void StreamBuffer::orphan()
+{
+    // fresh storage under the same name. whatever the GPU is still drawing
+    // from stays alive in the old storage until it's done
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_capacity, NULL, GL_STREAM_DRAW);
+    m_head = 0;
+}
+
+GLintptr StreamBuffer::write(const void* data, GLsizeiptr size)
+{
+    GLintptr offset = (m_head + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    // a write bigger than the whole buffer: grow it, which orphans it anyway. at
+    // least to size, so an empty buffer (capacity 0) grows too
+    if (size > m_capacity) {
+        m_capacity = std::max(m_capacity * 2, size);
+        orphan();
+        offset = 0;
+        m_wraps++;
+    }
+    else if (offset + size > m_capacity) {
+        orphan();
+        offset = 0;
+        m_wraps++;
+    }
+    else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    }
+
+    if (m_map_range) {
+        // nothing queued reads from [offset, offset + size) of this storage,
+        // so there's no need for the driver to synchronise
+        void* destination = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (destination != NULL) {
+            memcpy(destination, data, size);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        else glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+    else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+
+    m_head = offset + size;
+    return offset;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// StreamBuffer: one vertex buffer that every piece of per-frame geometry is
+// streamed through. write() appends to the buffer like a ring: each write goes
+// just after the last one, and once the end is reached the whole buffer is
+// orphaned and writing starts again from the front. draws already queued keep
+// the old storage, so nothing ever waits on the GPU and no fences are needed.
+//
+// a write's range only lives until the buffer next wraps, so draw from it
+// straight away; anything drawn every frame unchanged belongs in its own buffer.
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+
+class StreamBuffer
+{
+private:
+    // keeps every write's offset a multiple of the vertex sizes we use
+    static const GLsizeiptr ALIGNMENT = 16;
+
+    GLuint     m_buffer   = 0;
+    GLsizeiptr m_capacity = 0;
+    GLintptr   m_head     = 0;
+
+    // without GL_ARB_map_buffer_range writes fall back to glBufferSubData
+    bool m_map_range = false;
+
+    int m_wraps = 0;
+
+    void orphan();
+
+public:
+    // ————— METHODS ————— //
+    static bool is_supported();
+
+    void initialise(GLsizeiptr capacity);
+    void shutdown();
+
+    // purpose: copy size bytes into the next free range of the buffer and
+    //          return that range's byte offset. leaves the buffer bound.
+    GLintptr write(const void* data, GLsizeiptr size);
+
+    // ————— GETTERS ————— //
+    GLuint     const get_buffer()   const { return m_buffer; };
+    GLsizeiptr const get_capacity() const { return m_capacity; };
+    int        const get_wraps()    const { return m_wraps; };
+};
@@ -0,0 +1,103 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <cstdio>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "TextRun.h"
+
+TextRun::TextRun(float screen_size, float spacing, glm::vec3 position)
+{
+    m_screen_size = screen_size;
+    m_spacing     = spacing;
+    m_position    = position;
+}
+
+void TextRun::initialise(const AtlasRegion& font, StreamBuffer* stream)
+{
+    m_font   = font;
+    m_stream = stream;
+    layout();
+}
+
+void TextRun::set_text(const char* text)
+{
+    if (m_text == text) return;
+
+    // assign reuses m_text's storage unless the new text is longer than any before
+    m_text.assign(text);
+    layout();
+}
+
+void TextRun::layout()
+{
+    // Scale the size of the fontbank in the UV-plane
+    // We will use this for spacing and positioning
+    // (the fontbank is one region of the atlas, so scale to that region)
+    float region_width  = m_font.uv_rect.z - m_font.uv_rect.x;
+    float region_height = m_font.uv_rect.w - m_font.uv_rect.y;
+    float width  = region_width / FONTBANK_SIZE;
+    float height = region_height / FONTBANK_SIZE;
+    float half   = 0.5f * m_screen_size;
+
+    m_vertices.resize(m_text.size() * 6 * 4);
+    float* vertex = m_vertices.data();
+
+    // For every character...
+    for (int i = 0; i < (int) m_text.size(); i++) {
+        // 1. Get their index in the spritesheet, as well as their offset (i.e. their position
+        //    relative to the whole sentence)
+        int spritesheet_index = (int) m_text[i];  // ascii value of character
+        float offset = (m_screen_size + m_spacing) * i;
+
+        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
+        float u_coordinate = m_font.uv_rect.x + (float) (spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE * region_width;
+        float v_coordinate = m_font.uv_rect.y + (float) (spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE * region_height;
+
+        // 3. Write the glyph's two triangles, x, y, u, v per vertex
+        float glyph[] = {
+            offset - half,  half, u_coordinate,         v_coordinate,
+            offset - half, -half, u_coordinate,         v_coordinate + height,
+            offset + half,  half, u_coordinate + width, v_coordinate,
+            offset + half, -half, u_coordinate + width, v_coordinate + height,
+            offset + half,  half, u_coordinate + width, v_coordinate,
+            offset - half, -half, u_coordinate,         v_coordinate + height,
+        };
+        for (float value : glyph) *vertex++ = value;
+    }
+}
+
+void TextRun::render(ShaderProgram* program)
+{
+    if (m_text.empty()) return;
+
+    glm::mat4 model_matrix = glm::mat4(1.0f);
+    model_matrix = glm::translate(model_matrix, m_position);
+    program->set_model_matrix(model_matrix);
+
+    // write() leaves the stream bound
+    GLintptr offset = m_stream->write(m_vertices.data(), m_vertices.size() * sizeof(float));
+
+    GLsizei stride = 4 * sizeof(float);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (void*) offset);
+    ShaderProgram::enable_attribute(program->get_position_attribute());
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride, (void*) (offset + 2 * sizeof(float)));
+    ShaderProgram::enable_attribute(program->get_tex_coordinate_attribute());
+
+    ShaderProgram::bind_texture(m_font.texture_id);
+    glDrawArrays(GL_TRIANGLES, 0, (int) (m_text.size() * 6));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void format_number(char* buffer, int buffer_size, const char* label, float value)
+{
+    snprintf(buffer, buffer_size, "%s%f", label, value);
+}
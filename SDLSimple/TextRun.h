@@ -0,0 +1,54 @@
+#pragma once
+
+// TextRun: one line of HUD text, laid out once. the glyph quads are only
+// rebuilt when set_text() is given something different, into a vertex array
+// that's reused, so drawing the same text every frame (or text that changes but
+// doesn't grow) never allocates. render() streams the quads into the frame's
+// StreamBuffer and draws them from there.
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include "glm/vec3.hpp"
+#include "ShaderProgram.h"
+#include "TextureAtlas.h"
+#include "StreamBuffer.h"
+
+class TextRun
+{
+private:
+    // the font is a 16 x 16 grid of ascii glyphs
+    static const int FONTBANK_SIZE = 16;
+
+    AtlasRegion   m_font;
+    StreamBuffer* m_stream = NULL;
+    float       m_screen_size;
+    float       m_spacing;
+    glm::vec3   m_position;
+
+    std::string        m_text;     // what's laid out right now
+    std::vector<float> m_vertices; // x, y, u, v per vertex, 6 vertices per glyph
+
+    void layout();
+
+public:
+    // ————— METHODS ————— //
+    TextRun(float screen_size, float spacing, glm::vec3 position);
+
+    void initialise(const AtlasRegion& font, StreamBuffer* stream);
+
+    // purpose: change the text, relaying it out only if it's actually different
+    void set_text(const char* text);
+    void render(ShaderProgram* program);
+
+    // ————— GETTERS ————— //
+    std::string const& get_text() const { return m_text; };
+};
+
+// purpose: "<label><value>" with value printed like std::to_string does ("%f"),
+//          into a caller's fixed buffer instead of a new string
+void format_number(char* buffer, int buffer_size, const char* label, float value);
@@ -0,0 +1,419 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstring>
+#include "ShaderProgram.h"
+#include "TextureAtlas.h"
+
+const int SMALLEST_PAGE = 64;
+
+// how each format goes to glTexImage2D
+struct FormatInfo
+{
+    GLint  internal_format;
+    GLenum format, type;
+    int    bytes_per_texel;
+};
+
+const FormatInfo FORMATS[FORMAT_COUNT] =
+{
+    { GL_INTENSITY8,         GL_LUMINANCE,       GL_UNSIGNED_BYTE,          1 }, // samples as (a, a, a, a)
+    { GL_LUMINANCE8_ALPHA8,  GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE,          2 },
+    { GL_RGB5,               GL_RGB,             GL_UNSIGNED_SHORT_5_6_5,   2 },
+    { GL_RGBA4,              GL_RGBA,            GL_UNSIGNED_SHORT_4_4_4_4, 2 },
+    { GL_RGBA,               GL_RGBA,            GL_UNSIGNED_BYTE,          4 },
+};
+
+// purpose: value (0-255) rounded to bits bits
+unsigned short quantise(unsigned char value, int bits)
+{
+    int largest = (1 << bits) - 1;
+    return (unsigned short) ((value * largest + 127) / 255);
+}
+
+// purpose: RGBA texels as format wants them. RGBA8 isn't converted, it goes up as is
+void convert(const unsigned char* texels, int count, TextureFormat format, std::vector<unsigned char>& converted)
+{
+    converted.resize((size_t) count * FORMATS[format].bytes_per_texel);
+    unsigned short* shorts = (unsigned short*) converted.data();
+
+    for (int i = 0; i < count; i++) {
+        const unsigned char* texel = texels + i * 4;
+        switch (format) {
+            case FORMAT_ALPHA8:
+                converted[i] = texel[3];
+                break;
+            case FORMAT_LA8:
+                converted[i * 2 + 0] = texel[0];
+                converted[i * 2 + 1] = texel[3];
+                break;
+            case FORMAT_RGB565:
+                shorts[i] = (unsigned short) (quantise(texel[0], 5) << 11 | quantise(texel[1], 6) << 5 | quantise(texel[2], 5));
+                break;
+            case FORMAT_RGBA4444:
+                shorts[i] = (unsigned short) (quantise(texel[0], 4) << 12 | quantise(texel[1], 4) << 8 |
+                                              quantise(texel[2], 4) << 4  | quantise(texel[3], 4));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// purpose: the next mip level down: every texel the average of the 2x2 above it.
+//          colours are weighted by alpha, so clear texels don't darken the edges
+void downsample(const unsigned char* texels, int width, int height, std::vector<unsigned char>& smaller)
+{
+    int smaller_width  = std::max(width / 2, 1),
+        smaller_height = std::max(height / 2, 1);
+    smaller.resize((size_t) smaller_width * smaller_height * 4);
+
+    for (int y = 0; y < smaller_height; y++) {
+        for (int x = 0; x < smaller_width; x++) {
+            int sums[4] = { 0, 0, 0, 0 }, plain[3] = { 0, 0, 0 };
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    int column = std::min(x * 2 + dx, width - 1),
+                        row    = std::min(y * 2 + dy, height - 1);
+                    const unsigned char* texel = texels + ((size_t) row * width + column) * 4;
+                    for (int c = 0; c < 3; c++) {
+                        sums[c]  += texel[c] * texel[3];
+                        plain[c] += texel[c];
+                    }
+                    sums[3] += texel[3];
+                }
+            }
+
+            unsigned char* out = &smaller[((size_t) y * smaller_width + x) * 4];
+            for (int c = 0; c < 3; c++) {
+                out[c] = (unsigned char) (sums[3] > 0 ? (sums[c] + sums[3] / 2) / sums[3] : (plain[c] + 2) / 4);
+            }
+            out[3] = (unsigned char) ((sums[3] + 2) / 4);
+        }
+    }
+}
+
+// purpose: the first format that holds texels exactly or, if reduced, close enough.
+//          ALPHA8 samples as (a, a, a, a), which is only exact while nothing blends texels
+TextureFormat choose_format(const unsigned char* texels, int count, bool reduced, bool mipmapped)
+{
+    bool white_or_clear = !mipmapped, grey = true, opaque = true;
+    for (int i = 0; i < count && (white_or_clear || grey || opaque); i++) {
+        const unsigned char* texel = texels + i * 4;
+        if (texel[3] != 0 && (texel[3] != 255 || texel[0] != 255 || texel[1] != 255 || texel[2] != 255)) white_or_clear = false;
+        if (texel[0] != texel[1] || texel[1] != texel[2]) grey = false;
+        if (texel[3] != 255) opaque = false;
+    }
+
+    if (white_or_clear) return FORMAT_ALPHA8;
+    if (grey)           return FORMAT_LA8;
+    if (!reduced)       return FORMAT_RGBA8;
+    return opaque ? FORMAT_RGB565 : FORMAT_RGBA4444;
+}
+
+TextureAtlas::TextureAtlas(int max_size)
+{
+    m_max_size = max_size;
+}
+
+void TextureAtlas::set_mip_levels(int mip_levels)
+{
+    // a texel of level n covers 2^n of the full size one, so images sit on spots
+    // that are multiples of that, with a border of at least that much around them
+    m_mip_levels = mip_levels;
+    m_alignment  = 1 << mip_levels;
+    m_border     = std::max((int) BORDER, m_alignment);
+}
+
+
+int TextureAtlas::add(const unsigned char* pixels, int width, int height)
+{
+    Image image;
+    image.pixels.assign(pixels, pixels + width * height * 4);
+    image.width  = width;
+    image.height = height;
+    image.page   = -1;
+    image.x      = 0;
+    image.y      = 0;
+    image.baked  = false;
+    image.format = FORMAT_RGBA8;
+
+    m_images.push_back(std::move(image));
+    return (int) m_images.size() - 1;
+}
+
+int TextureAtlas::add_baked_page(const unsigned char* texels, int width, int height, TextureFormat format, int mip_levels)
+{
+    Page page = { width, height, 0, texels, mip_levels, format };
+    m_pages.push_back(page);
+    return (int) m_pages.size() - 1;
+}
+
+int TextureAtlas::add_baked_image(int page, int x, int y, int width, int height)
+{
+    Image image;
+    image.width  = width;
+    image.height = height;
+    image.page   = page;
+    image.x      = x;
+    image.y      = y;
+    image.baked  = true;
+    image.format = FORMAT_RGBA8;
+
+    m_images.push_back(std::move(image));
+    return (int) m_images.size() - 1;
+}
+
+// purpose: shelf-pack as many of images as fit into a size x size page. with commit,
+//          the ones that fit are given their spot and taken off the list
+bool TextureAtlas::place(std::vector<int>& images, int page, int size, bool commit)
+{
+    int x = 0, y = 0, shelf_height = 0;
+    bool all_fit = true;
+    std::vector<int> left_over;
+
+    for (int index : images) {
+        Image& image = m_images[index];
+        int width  = padded(image.width),
+            height = padded(image.height);
+
+        // start a new shelf when this row is full
+        if (x + width > size) {
+            y += shelf_height;
+            x = 0;
+            shelf_height = 0;
+        }
+
+        if (width > size || y + height > size) {
+            all_fit = false;
+            left_over.push_back(index);
+            continue;
+        }
+
+        if (commit) {
+            image.page = page;
+            image.x    = x + m_border;
+            image.y    = y + m_border;
+        }
+        x += width;
+        shelf_height = std::max(shelf_height, height);
+    }
+
+    if (commit) images.swap(left_over);
+    return all_fit;
+}
+
+void TextureAtlas::layout()
+{
+    // baked pages come first and stay, anything after them is laid out again
+    while (!m_pages.empty() && m_pages.back().baked_texels == NULL) {
+        if (m_pages.back().texture_id != 0) ShaderProgram::delete_texture(m_pages.back().texture_id);
+        m_pages.pop_back();
+    }
+
+    // each image's format is judged as full precision. pack() can still store a whole page smaller
+    std::vector<int> waiting;
+    for (int i = 0; i < (int) m_images.size(); i++) {
+        Image& image = m_images[i];
+        if (image.baked) continue;
+
+        image.format = choose_format(image.pixels.data(), image.width * image.height, false, m_mip_levels > 0);
+
+        waiting.push_back(i);
+    }
+
+    // one format at a time, tallest first, which keeps the shelves tight
+    std::sort(waiting.begin(), waiting.end(), [this](int a, int b) {
+        if (m_images[a].format != m_images[b].format) return m_images[a].format < m_images[b].format;
+        if (m_images[a].height != m_images[b].height) return m_images[a].height > m_images[b].height;
+        return m_images[a].width > m_images[b].width;
+    });
+
+    std::vector<int> remaining;
+    for (size_t next = 0; next < waiting.size(); ) {
+        remaining.clear();
+        TextureFormat format = m_images[waiting[next]].format;
+        while (next < waiting.size() && m_images[waiting[next]].format == format) remaining.push_back(waiting[next++]);
+
+        lay_out_pages(remaining);
+    }
+}
+
+void TextureAtlas::lay_out_pages(std::vector<int>& remaining)
+{
+    // too big for any page: each gets one of its own, just its size. done first, so
+    // they don't make the pages the others share as big as they can go
+    std::vector<int> fitting;
+    for (int index : remaining) {
+        Image& image = m_images[index];
+        if (padded(image.width) <= m_max_size && padded(image.height) <= m_max_size) {
+            fitting.push_back(index);
+            continue;
+        }
+
+        image.page = (int) m_pages.size();
+        image.x    = m_border;
+        image.y    = m_border;
+
+        Page own_page = { padded(image.width), padded(image.height), 0, NULL, m_mip_levels, FORMAT_RGBA8 };
+        m_pages.push_back(own_page);
+    }
+    remaining.swap(fitting);
+
+    while (!remaining.empty()) {
+        int page = (int) m_pages.size();
+
+        // the smallest power of two that takes everything left, up to max_size
+        int size = SMALLEST_PAGE;
+        while (size < m_max_size && !place(remaining, page, size, false)) size *= 2;
+        place(remaining, page, size, true);
+
+        Page new_page = { size, size, 0, NULL, m_mip_levels, FORMAT_RGBA8 };
+        m_pages.push_back(new_page);
+    }
+}
+
+void TextureAtlas::compose_page(int page, std::vector<unsigned char>& texels) const
+{
+    Page const& target = m_pages[page];
+    texels.assign(target.width * target.height * 4, 0);
+
+    for (Image const& image : m_images) {
+        if (image.page != page || image.baked) continue;
+
+        // the image plus its border, clamping into the image for the border texels. the
+        // border runs out to the aligned edge, so mip levels only ever see this image
+        for (int row = -m_border; row < padded(image.height) - m_border; row++) {
+            int source_row = std::min(std::max(row, 0), image.height - 1);
+            for (int column = -m_border; column < padded(image.width) - m_border; column++) {
+                int source_column = std::min(std::max(column, 0), image.width - 1);
+                memcpy(&texels[((image.y + row) * target.width + image.x + column) * 4],
+                       &image.pixels[(source_row * image.width + source_column) * 4], 4);
+            }
+        }
+    }
+}
+
+void TextureAtlas::encode_page(int page, std::vector<unsigned char>& encoded)
+{
+    Page& target = m_pages[page];
+    std::vector<unsigned char> texels, smaller, converted;
+    compose_page(page, texels);
+    target.format = choose_format(texels.data(), target.width * target.height, m_reduced_precision, target.mip_levels > 0);
+
+    encoded.clear();
+    encoded.reserve(get_encoded_size(target.width, target.height, target.format, target.mip_levels));
+
+    int width = target.width, height = target.height;
+    for (int l = 0; l <= target.mip_levels; l++) {
+        if (l > 0) {
+            downsample(texels.data(), width, height, smaller);
+            texels.swap(smaller);
+            width  = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+
+        if (target.format == FORMAT_RGBA8) {
+            encoded.insert(encoded.end(), texels.begin(), texels.end());
+            continue;
+        }
+        convert(texels.data(), width * height, target.format, converted);
+        encoded.insert(encoded.end(), converted.begin(), converted.end());
+    }
+}
+
+void TextureAtlas::pack()
+{
+    layout();
+
+    // ————— UPLOAD ————— //
+    std::vector<unsigned char> encoded;
+    for (int p = 0; p < (int) m_pages.size(); p++) {
+        Page& page = m_pages[p];
+        if (page.texture_id != 0) continue;
+
+        // baked texels go up exactly as they are, no copy on the way
+        if (page.baked_texels != NULL) {
+            upload(page, page.baked_texels);
+            continue;
+        }
+
+        encode_page(p, encoded);
+        upload(page, encoded.data());
+    }
+}
+
+void TextureAtlas::upload(Page& page, const unsigned char* encoded)
+{
+    FormatInfo const& format = FORMATS[page.format];
+
+    glGenTextures(1, &page.texture_id);
+    ShaderProgram::bind_texture(page.texture_id);
+
+    // the 1 and 2 byte formats don't fill out rows to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // the levels follow each other, full size first
+    int width = page.width, height = page.height;
+    for (int l = 0; l <= page.mip_levels; l++) {
+        glTexImage2D(GL_TEXTURE_2D, l, format.internal_format, width, height, 0, format.format, format.type, encoded);
+        encoded += (size_t) width * height * format.bytes_per_texel;
+        width  = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, page.mip_levels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, page.mip_levels > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void TextureAtlas::shutdown()
+{
+    for (Page& page : m_pages) {
+        if (page.texture_id != 0) ShaderProgram::delete_texture(page.texture_id);
+    }
+    m_pages.clear();
+}
+
+void TextureAtlas::clear()
+{
+    shutdown();
+    m_images.clear();
+}
+
+size_t TextureAtlas::get_encoded_size(int width, int height, TextureFormat format, int mip_levels)
+{
+    size_t bytes = 0;
+    for (int l = 0; l <= mip_levels; l++) {
+        bytes += (size_t) width * height * FORMATS[format].bytes_per_texel;
+        width  = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return bytes;
+}
+
+AtlasRegion const TextureAtlas::get_region(int image) const
+{
+    Image const& packed = m_images[image];
+    Page const&  page   = m_pages[packed.page];
+
+    AtlasRegion region;
+    region.texture_id = page.texture_id;
+    region.uv_rect    = glm::vec4((float) packed.x / page.width,
+                                  (float) packed.y / page.height,
+                                  (float) (packed.x + packed.width)  / page.width,
+                                  (float) (packed.y + packed.height) / page.height);
+    return region;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+// TextureAtlas: packs every sprite image into one (or, if they don't all fit
+// under max_size, a few) textures at startup, so sprites that use different
+// images can still share a texture bind and a batch. images are shelf-packed
+// tallest first with a 1 texel border copied from their own edges, so nearest
+// sampling right at a region's edge never picks up a neighbour.
+//
+// every page is stored in the smallest format that holds its texels (see
+// TextureFormat). images only share pages with others that need the same format,
+// so one colour sprite can't keep the greyscale font at 4 bytes a texel. images too
+// big for max_size get a page of exactly their size. pages can have a mip chain,
+// built on the CPU, for sprites drawn smaller than their images: the border then
+// grows and images sit on aligned spots, so no mip level blends two of them.
+//
+// pages can also come ready-made (an AssetPack bakes them offline): a baked page
+// is already in its format, mip chain and all (see encode_page()). it's uploaded
+// straight from the texels it's given and never repacked, and its images only
+// record where they sit on it.
+
+#ifdef _WINDOWS
+    #include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/vec4.hpp"
+
+// what a page is stored as on the GPU. encode_page() picks from its texels: the
+// first one that holds them exactly, or, with reduced precision, close enough
+enum TextureFormat
+{
+    FORMAT_ALPHA8,   // 1 byte: white where it isn't clear, and clear or solid only. not with mipmaps
+    FORMAT_LA8,      // 2 bytes: greyscale, like the font
+    FORMAT_RGB565,   // 2 bytes: opaque. reduced precision only
+    FORMAT_RGBA4444, // 2 bytes: reduced precision only
+    FORMAT_RGBA8,    // 4 bytes: anything
+    FORMAT_COUNT
+};
+
+// where an image ended up: which texture, and the (u0, v0, u1, v1) it covers, v0 at the top
+struct AtlasRegion
+{
+    GLuint    texture_id;
+    glm::vec4 uv_rect;
+};
+
+class TextureAtlas
+{
+private:
+    struct Image
+    {
+        std::vector<unsigned char> pixels; // RGBA, top row first, empty if baked
+        int width, height;
+        int page, x, y;                    // where pack() put it, x and y inside the border
+        bool baked;
+        TextureFormat format;              // what it needs, pages only hold one kind
+    };
+
+    struct Page
+    {
+        int    width, height;
+        GLuint texture_id;
+        const unsigned char* baked_texels; // NULL for pages pack() composes
+        int    mip_levels;                 // under the full size one
+        TextureFormat format;              // what encode_page() chose
+    };
+
+    int  m_max_size;
+    int  m_mip_levels        = 0;
+    int  m_border            = BORDER;
+    int  m_alignment         = 1;
+    bool m_reduced_precision = false;
+
+    std::vector<Image> m_images;
+    std::vector<Page>  m_pages;
+
+    int  padded(int size) const { return (size + 2 * m_border + m_alignment - 1) / m_alignment * m_alignment; };
+    bool place(std::vector<int>& images, int page, int size, bool commit);
+    void lay_out_pages(std::vector<int>& images);
+    void upload(Page& page, const unsigned char* encoded);
+
+public:
+    static const int BORDER = 1; // without mipmaps
+
+    // ————— METHODS ————— //
+    TextureAtlas(int max_size = 2048);
+
+    // purpose: give pages mip_levels levels under the full size one (0 for none),
+    //          drawn with trilinear filtering when minified. before layout()
+    void set_mip_levels(int mip_levels);
+
+    // purpose: let pages go down to 16 bits a texel (RGBA4444, RGB565) when
+    //          that's all that's left. before pack() or encode_page()
+    void set_reduced_precision(bool reduced) { m_reduced_precision = reduced; };
+
+    // purpose: copy in an RGBA image to be packed, returns its index
+    int add(const unsigned char* pixels, int width, int height);
+
+    // purpose: take a ready-made page and an image on it. the texels, as encode_page()
+    //          wrote them, are uploaded by the next pack() right where they lie, so they
+    //          have to stay valid until then. baked pages go in before anything is packed
+    int add_baked_page(const unsigned char* texels, int width, int height, TextureFormat format, int mip_levels);
+    int add_baked_image(int page, int x, int y, int width, int height);
+
+    // purpose: lay every added image out over as few pages as it takes. needs no GL
+    //          until there are uploaded pages to lay out again (they're freed)
+    void layout();
+
+    // purpose: a laid out page's texels, with every image on it and their borders
+    void compose_page(int page, std::vector<unsigned char>& texels) const;
+
+    // purpose: a laid out page as it goes to the GPU: composed, its format chosen,
+    //          then every level from the full size one down, converted, one after another
+    void encode_page(int page, std::vector<unsigned char>& encoded);
+
+    // purpose: layout() and upload every page that isn't on the GPU yet
+    void pack();
+    void shutdown();
+
+    // purpose: free the pages and forget every image, indices start from 0 again
+    void clear();
+
+    // ————— GETTERS ————— //
+    AtlasRegion const get_region(int image) const;
+    int         const get_image_count()     const { return (int) m_images.size(); };
+    int         const get_page_count()      const { return (int) m_pages.size(); };
+    int         const get_mip_levels()      const { return m_mip_levels; };
+
+    // how much encode_page() writes for a page like that
+    static size_t get_encoded_size(int width, int height, TextureFormat format, int mip_levels);
+
+    // where layout() put things, for baking them
+    int           const get_page_width(int page)  const { return m_pages[page].width; };
+    int           const get_page_height(int page) const { return m_pages[page].height; };
+    TextureFormat const get_page_format(int page) const { return m_pages[page].format; }; // once it's encoded
+    void          const get_placement(int image, int& page, int& x, int& y) const
+    {
+        page = m_images[image].page;
+        x    = m_images[image].x;
+        y    = m_images[image].y;
+    };
+};
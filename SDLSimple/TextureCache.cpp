@@ -0,0 +1,326 @@
+//    Author: Nabira Ahmad
+//    Assignment: Lunar Lander
+//    Date due: 2024-03-09, 11:59pm
+//    I pledge that I have completed this assignment without
+//    collaborating with anyone else, in conformance with the
+//    NYU School of Engineering Policies and Procedures on
+//    Academic Misconduct.
+
+#define STB_IMAGE_IMPLEMENTATION
+// images decode on several threads at once, and the failure string is one global
+// they'd all write. this turns off stbi__err's writes, and the one direct write (in
+// stbi__gif_header) is patched in stb_image.h to honour it too
+#define STBI_NO_FAILURE_STRINGS
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "stb_image.h"
+#include "TextureCache.h"
+
+// purpose: the absolute path with every ".", ".." and link resolved, or the path
+//          as given if it doesn't exist (decoding it will say so)
+std::string canonical_path(const char* filepath)
+{
+#ifdef _WINDOWS
+    char resolved[_MAX_PATH];
+    if (_fullpath(resolved, filepath, _MAX_PATH) != NULL) return resolved;
+#else
+    char resolved[PATH_MAX];
+    if (realpath(filepath, resolved) != NULL) return resolved;
+#endif
+    return filepath;
+}
+
+// a GIF frame that doesn't say how long it shows for gets this long, like in a browser
+const float DEFAULT_FRAME_DELAY = 0.1f;
+
+// what an image that couldn't be decoded is drawn with: one clear texel
+const unsigned char MISSING_TEXEL[4] = { 0, 0, 0, 0 };
+
+// purpose: every frame of a GIF, each one whole (already composited over the ones
+//          before it), and how long each shows. nothing if the file isn't a GIF
+void decode_gif_frames(FILE* file, std::vector<unsigned char*>& frames, std::vector<float>& delays, int& width, int& height)
+{
+    stbi__context context;
+    stbi__start_file(&context, file);
+    if (!stbi__gif_test(&context)) return;
+
+    // this stb_image (v2.12) only hands out a GIF's first frame, so walk its decoder
+    // by hand. every stbi__gif_load_next() composes the next frame into a new buffer
+    // and keeps the ones before it around for disposal, so they're only freed by the caller
+    stbi__gif* gif = (stbi__gif*) calloc(1, sizeof(stbi__gif));
+    int number_of_components;
+    for (;;) {
+        stbi_uc* frame = stbi__gif_load_next(&context, gif, &number_of_components, STBI_rgb_alpha);
+        if (frame == NULL || frame == (stbi_uc*) &context) break; // broken, or the end of the stream
+
+        frames.push_back(frame);
+        delays.push_back(gif->delay > 0 ? gif->delay / 100.0f : DEFAULT_FRAME_DELAY); // in 1/100ths of a second
+    }
+
+    // it allocates the buffer for the next frame before finding there isn't one
+    if (gif->out != NULL && (frames.empty() || gif->out != frames.back())) stbi_image_free(gif->out);
+
+    width  = gif->w;
+    height = gif->h;
+    free(gif);
+}
+
+TextureCache::DecodedImage TextureCache::decode(std::string filepath, int mip_levels)
+{
+    DecodedImage image;
+
+    std::vector<unsigned char*> frames;
+    FILE* file = fopen(filepath.c_str(), "rb");
+    if (file != NULL) {
+        decode_gif_frames(file, frames, image.animation.delays, image.width, image.height);
+        fclose(file);
+    }
+
+    // not a GIF
+    if (frames.empty()) {
+        int number_of_components;
+        image.animation.delays.clear();
+        image.pixels = stbi_load(filepath.c_str(), &image.width, &image.height, &number_of_components, STBI_rgb_alpha);
+        return image;
+    }
+
+    // a GIF that doesn't move is just an image
+    if (frames.size() == 1) {
+        image.animation.delays.clear();
+        image.pixels = frames[0];
+        return image;
+    }
+
+    // ————— SHEET ————— //
+    // a grid about as wide as it is tall, so a long animation doesn't make one very wide image
+    Animation& animation  = image.animation;
+    animation.frame_count = (int) frames.size();
+    animation.columns     = (int) ceilf(sqrtf((float) animation.frame_count));
+    animation.rows        = (animation.frame_count + animation.columns - 1) / animation.columns;
+
+    // with mipmaps the atlas gives every image a border of its own edge and starts it on
+    // a 1 << mip_levels boundary (see TextureAtlas::set_mip_levels), so that no level
+    // blends two images. frames on one sheet need the same between each other
+    int alignment = 1 << mip_levels,
+        gutter    = mip_levels > 0 ? alignment : 0;
+
+    int frame_width  = image.width,
+        frame_height = image.height,
+        cell_width   = (frame_width + 2 * gutter + alignment - 1) / alignment * alignment,
+        cell_height  = (frame_height + 2 * gutter + alignment - 1) / alignment * alignment;
+    image.width  = cell_width * animation.columns;
+    image.height = cell_height * animation.rows;
+
+    animation.frame_rect = glm::vec4((float) gutter / cell_width, (float) gutter / cell_height,
+                                     (float) (gutter + frame_width) / cell_width,
+                                     (float) (gutter + frame_height) / cell_height);
+
+    // stb_image's allocator, so the sheet is freed like any other decoded image
+    image.pixels = (unsigned char*) stbi__malloc(image.width * image.height * 4);
+    memset(image.pixels, 0, image.width * image.height * 4);
+
+    for (int f = 0; f < animation.frame_count; f++) {
+        int left = (f % animation.columns) * cell_width,
+            top  = (f / animation.columns) * cell_height;
+
+        // the whole cell, the gutter being copies of the frame's nearest edge texel
+        for (int y = 0; y < cell_height; y++) {
+            int source_y = std::min(std::max(y - gutter, 0), frame_height - 1);
+            unsigned char* row = image.pixels + ((top + y) * image.width + left) * 4;
+            const unsigned char* source = frames[f] + source_y * frame_width * 4;
+
+            for (int x = 0; x < cell_width; x++) {
+                int source_x = std::min(std::max(x - gutter, 0), frame_width - 1);
+                memcpy(row + x * 4, source + source_x * 4, 4);
+            }
+        }
+        stbi_image_free(frames[f]);
+    }
+
+    return image;
+}
+
+void TextureCache::initialise(TextureAtlas* atlas)
+{
+    m_atlas = atlas;
+
+    // stb_image fills in its fixed huffman tables the first time a png needs them.
+    // do it here, before there are decodes on other threads to race on it
+    stbi__init_zdefaults();
+}
+
+void TextureCache::use_pack(const AssetPack& pack)
+{
+    // an image whose file changed after baking is left out, so it's decoded from the
+    // file like anything else. a page with nothing current left on it isn't uploaded
+    std::vector<bool> current(pack.get_image_count());
+    std::vector<int>  pages(pack.get_page_count(), -1); // pack page -> atlas page
+    for (int i = 0; i < pack.get_image_count(); i++) {
+        current[i] = pack.is_current(i);
+        if (current[i]) pages[pack.get_image(i).page] = 0;
+    }
+
+    for (int p = 0; p < pack.get_page_count(); p++) {
+        if (pages[p] < 0) continue;
+
+        AssetPack::PageEntry const& page = pack.get_page(p);
+        pages[p] = m_atlas->add_baked_page(pack.get_texels(p), (int) page.width, (int) page.height,
+                                           (TextureFormat) page.format, (int) page.mip_levels);
+        m_unpacked = true;
+    }
+
+    for (int i = 0; i < pack.get_image_count(); i++) {
+        if (!current[i]) continue;
+        AssetPack::ImageEntry const& image = pack.get_image(i);
+
+        BakedImage& baked = m_baked[canonical_path(image.name)];
+        baked.image = m_atlas->add_baked_image(pages[image.page], image.x, image.y, image.width, image.height);
+        baked.animation.frame_count = (int) image.frame_count;
+        baked.animation.columns     = (int) image.columns;
+        baked.animation.rows        = (int) image.rows;
+        baked.animation.frame_rect  = glm::vec4(image.frame_rect[0], image.frame_rect[1], image.frame_rect[2], image.frame_rect[3]);
+        if (image.frame_count > 1) {
+            const float* delays = pack.get_delays() + image.first_delay;
+            baked.animation.delays.assign(delays, delays + image.frame_count);
+        }
+    }
+}
+
+TextureHandle TextureCache::acquire(const char* filepath)
+{
+    std::string path = canonical_path(filepath);
+
+    std::unordered_map<std::string, TextureHandle>::iterator found = m_handles.find(path);
+    if (found != m_handles.end()) {
+        m_entries[found->second].references++;
+        return found->second;
+    }
+
+    Entry entry;
+    entry.path       = path;
+    entry.references = 1;
+
+    std::unordered_map<std::string, BakedImage>::iterator baked = m_baked.find(path);
+    if (baked != m_baked.end()) {
+        entry.image     = baked->second.image;
+        entry.animation = baked->second.animation;
+    }
+    else {
+        entry.image   = DECODING;
+        entry.decoded = std::async(std::launch::async, decode, std::string(filepath), m_atlas->get_mip_levels());
+        m_decode_count++;
+        m_pending++;
+    }
+
+    TextureHandle handle;
+    if (!m_free_handles.empty()) {
+        handle = m_free_handles.back();
+        m_free_handles.pop_back();
+        m_entries[handle] = std::move(entry);
+    }
+    else {
+        handle = (TextureHandle) m_entries.size();
+        m_entries.push_back(std::move(entry));
+    }
+
+    m_handles[path] = handle;
+    m_live_count++;
+    return handle;
+}
+
+void TextureCache::retain(TextureHandle handle)
+{
+    if (!is_held(handle))
+    {
+        std::cout << "Retained a texture handle that isn't held." << '\n';
+        assert(false);
+        return;
+    }
+    m_entries[handle].references++;
+}
+
+void TextureCache::release(TextureHandle handle)
+{
+    if (handle == NO_TEXTURE) return;
+
+    // a second release would hand the same handle out twice
+    if (!is_held(handle))
+    {
+        std::cout << "Released a texture handle that isn't held." << '\n';
+        assert(false);
+        return;
+    }
+
+    Entry& entry = m_entries[handle];
+    assert(entry.references > 0);
+    if (--entry.references > 0) return;
+
+    // nobody wants it any more, but the decode still has to finish before it can be freed
+    if (entry.image == DECODING) {
+        DecodedImage image = entry.decoded.get();
+        if (image.pixels != NULL) stbi_image_free(image.pixels);
+        m_pending--;
+    }
+
+    m_handles.erase(entry.path);
+    entry.path.clear();
+    m_free_handles.push_back(handle);
+
+    // nothing left to draw from the atlas: give all of it back
+    if (--m_live_count == 0) {
+        m_atlas->clear();
+        m_entries.clear();
+        m_free_handles.clear();
+        m_baked.clear();
+        m_unpacked = false;
+    }
+}
+
+AtlasRegion const TextureCache::get_region(TextureHandle handle) const
+{
+    if (!is_held(handle) || m_entries[handle].image == DECODING)
+    {
+        std::cout << "Asked where a texture is before it's held and drained." << '\n';
+        assert(false);
+        return AtlasRegion { 0, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f) };
+    }
+    return m_atlas->get_region(m_entries[handle].image);
+}
+
+void TextureCache::drain()
+{
+    if (m_pending == 0 && !m_unpacked) return;
+
+    // in handle order, not the order decodes finish in, so the atlas comes out
+    // the same every run
+    for (Entry& entry : m_entries) {
+        if (entry.path.empty() || entry.image != DECODING) continue;
+
+        DecodedImage image = entry.decoded.get();
+
+        // its handle still needs a region, so it gets a placeholder
+        if (image.pixels == NULL)
+        {
+            std::cout << "Unable to load image. Make sure the path is correct." << '\n';
+            assert(false);
+            entry.image = m_atlas->add(MISSING_TEXEL, 1, 1);
+            continue;
+        }
+
+        entry.image     = m_atlas->add(image.pixels, image.width, image.height);
+        entry.animation = std::move(image.animation);
+        stbi_image_free(image.pixels);
+    }
+
+    m_pending  = 0;
+    m_unpacked = false;
+    m_atlas->pack();
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+// TextureCache: hands out images by file path and decodes each file once, however
+// many sprites use it. paths are made canonical first, so "./fire.png" and
+// "fire.png" are the same image. every acquire() takes a reference and every
+// release() gives one back. an image nothing holds is forgotten, and once
+// nothing holds anything (the level has unloaded) the atlas is emptied and its
+// textures freed. an atlas page can't give back part of itself, so an image's
+// space only comes back along with everything else's.
+//
+// decoding is asynchronous: acquire() starts the file decoding on a worker
+// thread and hands back the handle straight away, so sprites can be set up (and
+// the window opened) while images are still coming in. drain(), on the GL
+// thread, waits for whatever is still decoding, adds the images to the atlas in
+// the order they were acquired and packs it. regions are only valid after that.
+//
+// an animated GIF comes in as all of its frames, laid out in a grid on one
+// sheet (left to right, then down) that goes in the atlas as a single image, with
+// how long each frame shows for. playing it is only picking a cell of the sheet,
+// see Entity::animate(): every frame is already on the GPU, in the same texture.
+//
+// with an AssetPack in use, images it has are never decoded at all: acquire()
+// finds them already laid out on the pack's pages and they're resident at once.
+
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TextureAtlas.h"
+#include "AssetPack.h"
+
+typedef int TextureHandle;
+const TextureHandle NO_TEXTURE = -1;
+
+// how an image's frames sit on its sheet. a still image is one frame, one cell
+struct Animation
+{
+    int                frame_count = 1;
+    int                columns     = 1;
+    int                rows        = 1;
+    std::vector<float> delays;     // seconds each frame shows for, empty for a still image
+
+    // where the frame sits in its cell, as fractions of the cell. with mipmaps a
+    // cell is the frame plus a gutter of its own edge texels, see decode()
+    glm::vec4          frame_rect  = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+};
+
+class TextureCache
+{
+public:
+    // RGBA, as stbi_load hands it back (free it with stbi_image_free). a GIF's
+    // frames come composed into one sheet. pixels is NULL if the file couldn't be read
+    struct DecodedImage
+    {
+        unsigned char* pixels = NULL;
+        int            width  = 0,
+                       height = 0;
+        Animation      animation;
+    };
+
+    // purpose: decode a file the way the cache does, on any thread. the asset packer uses it too.
+    //          a GIF's sheet leaves room between frames for an atlas with mip_levels
+    static DecodedImage decode(std::string filepath, int mip_levels);
+
+private:
+    enum { DECODING = -1 };
+
+    struct Entry
+    {
+        std::string               path;       // canonical, empty while the handle is free
+        int                       image;      // index in the atlas, DECODING until drain()
+        int                       references;
+        Animation                 animation;  // filled in along with image
+        std::future<DecodedImage> decoded;    // valid while image is DECODING
+    };
+
+    struct BakedImage
+    {
+        int       image;
+        Animation animation;
+    };
+
+    TextureAtlas* m_atlas = NULL;
+
+    std::vector<Entry>                             m_entries;
+    std::unordered_map<std::string, TextureHandle> m_handles;
+    std::vector<TextureHandle>                     m_free_handles;
+    std::unordered_map<std::string, BakedImage>    m_baked; // by canonical path, from the pack
+
+    // a handle that's held right now: in range and not given back
+    bool is_held(TextureHandle handle) const
+    {
+        return handle >= 0 && handle < (TextureHandle) m_entries.size() && m_entries[handle].references > 0;
+    };
+
+    int m_live_count   = 0;
+    int m_decode_count = 0;
+    int m_pending      = 0;     // handles still DECODING
+    bool m_unpacked    = false; // baked pages the atlas hasn't uploaded yet
+
+public:
+    // ————— METHODS ————— //
+    void initialise(TextureAtlas* atlas);
+
+    // purpose: put the pack's pages in the atlas, so acquiring anything it has
+    //          needs no decode. before the first acquire(); the pack stays open
+    //          until drain() has uploaded it. images whose file has changed since
+    //          they were baked are skipped, and decoded as usual. once the atlas
+    //          empties, the pack's images go with it and are decoded from their files again
+    void use_pack(const AssetPack& pack);
+
+    // purpose: a reference to the image at filepath. the first time, this only
+    //          starts it decoding, it isn't in the atlas until drain()
+    TextureHandle acquire(const char* filepath);
+    // every handle has to be held, release(NO_TEXTURE) does nothing
+    void          retain(TextureHandle handle);
+    void          release(TextureHandle handle);
+
+    // purpose: on the GL thread: wait for every image still decoding, add them to
+    //          the atlas and pack it if anything new went in
+    void drain();
+
+    // ————— GETTERS ————— //
+    AtlasRegion const get_region(TextureHandle handle) const;
+    int         const get_live_count()   const { return m_live_count; };   // distinct images held
+    int         const get_decode_count() const { return m_decode_count; }; // files decoded so far
+    bool        const is_resident(TextureHandle handle) const { return m_entries[handle].image != DECODING; };
+
+    // only valid once it's resident. the delays live as long as the handle does
+    Animation const& get_animation(TextureHandle handle) const { return m_entries[handle].animation; };
+};
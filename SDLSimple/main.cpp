@@ -7,21 +7,12 @@
 //    Academic Misconduct.
 
 #define LOG(argument) std::cout << argument << '\n'
-#define STB_IMAGE_IMPLEMENTATION
 #define GL_SILENCE_DEPRECATION
 #define GL_GLEXT_PROTOTYPES 1
 #define NUMBER_OF_ENEMIES 3
-#define FIXED_TIMESTEP 0.0166666f
-#define ACC_OF_GRAVITY -0.01f
-
-// count for every collidable entity
-// in this game: bad platforms, good platforms, and walls are collidable entities
 
 // to win:
     // avoid bad platforms and walls
-#define BAD_PLATFORM_COUNT 17
-#define GOOD_PLATFORM_COUNT 2
-#define WALL_COUNT 4
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -31,26 +22,40 @@
 #include <SDL_opengl.h>
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
+#include "glm/common.hpp"
 #include "ShaderProgram.h"
-#include "stb_image.h"
 #include "cmath"
 #include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
+#include <atomic>
+#include <thread>
 #include "Entity.h"
-
-// ————— STRUCTS AND ENUMS —————//
-struct GameState
-{
-    Entity* player;
-    Entity* bad_platform;
-    Entity* good_platform;
-    Entity* wall;
-};
+#include "LanderCore.h"
+#include "Registry.h"
+#include "RenderSystem.h"
+#include "StreamBuffer.h"
+#include "SpriteBatch.h"
+#include "InstancedSpriteBatch.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "AssetPack.h"
+#include "TextRun.h"
+#include "DrawList.h"
+#include "OffscreenTarget.h"
+#include "FramePacer.h"
 
 // ————— CONSTANTS ————— //
 const int WINDOW_WIDTH = 640*1.5,
 WINDOW_HEIGHT = 480*1.5;
 
+// how much of the level the camera shows: 10 x 7.5 units at 4:3. a headless
+// --size of another shape keeps the height and widens or narrows the view
+const float VIEW_HALF_WIDTH  = 5.0f,
+            VIEW_HALF_HEIGHT = 3.75f;
+
 const float BG_RED = 0.1922f,
             BG_BLUE = 0.549f,
             BG_GREEN = 0.9059f,
@@ -62,7 +67,8 @@ const int VIEWPORT_X = 0,
           VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-           F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+           F_SHADER_PATH[] = "shaders/fragment_textured.glsl",
+           V_INSTANCED_SHADER_PATH[] = "shaders/vertex_instanced.glsl";
 
 const float MILLISECONDS_IN_SECOND  = 1000.0;
 const char  SPRITESHEET_FILEPATH[]  = "pinkbutterfly.gif",
@@ -70,280 +76,294 @@ const char  SPRITESHEET_FILEPATH[]  = "pinkbutterfly.gif",
             GOOD_PLATFORM_FILEPATH[] = "flower.png",
             FONT_FILEPATH[] = "font1.png";
 
-const int NUMBER_OF_TEXTURES = 1;  // to be generated, that is
-const GLint LEVEL_OF_DETAIL  = 0;  // base image level; Level n is the nth mipmap reduction image
-const GLint TEXTURE_BORDER   = 0;  // this value MUST be zero
+// every image above, baked by --bake-assets. used when it's there, otherwise the files are decoded
+const char  ASSET_PACK_FILEPATH[] = "assets.pak";
+const char* const BAKED_FILEPATHS[] = { SPRITESHEET_FILEPATH, BAD_PLATFORM_FILEPATH,
+                                        GOOD_PLATFORM_FILEPATH, FONT_FILEPATH };
+
+// levels under the full size one that --mipmaps gives atlas pages
+const int MIP_LEVELS = 3;
+
+// most physics steps update() will run to catch up in one frame. past this the
+// backlog is dropped, so a slow frame can't snowball into ever slower ones
+const int MAX_STEPS_PER_FRAME = 8;
+
+// for when SDL can't tell what the display runs at
+const int DEFAULT_REFRESH_RATE = 60;
+
 
 // ————— VARIABLES ————— //
 
 GameState g_game_state;
+LanderState g_previous_state; // the state one physics step back, for render interpolation
+LanderInput g_input;
 bool g_game_is_running = true;
 
-// adding a timer to make it seem more like lunar lander :)
-bool g_timer_running = true;
-float g_timer_value = 0.0f;
-
 SDL_Window* g_display_window;
+SDL_GLContext g_context;
+
+// the simulation (this thread) hands each frame to the render thread, which owns
+// the GL context from the end of initialise() on, as a DrawList
+DrawListQueue g_draw_lists;
+std::thread g_render_thread;
+std::atomic<bool> g_render_running(false);
+
+// posted once per published list, the render thread sleeps on it in between
+SDL_sem* g_list_ready;
+
+// the main loop runs at the display's rate. a frame that would look exactly like
+// the last one isn't handed over at all, and once the run is over and nothing is
+// changing, the loop just sleeps until an event comes in
+FramePacer g_pacer;
+DrawList g_last_list;
+bool g_redraw = false; // the window needs the frame again, changed or not
 
 ShaderProgram g_shader_program;
+
+// every vertex that changes per frame (sprites, text) is appended here
+const GLsizeiptr STREAM_BUFFER_SIZE = 64 * 1024;
+StreamBuffer g_stream_buffer;
+SpriteBatch g_sprite_batch;
+
+// the level never moves, so its quads are uploaded once at load and only drawn after that
+SpriteBatch g_static_layer;
+
+// sprites go through instancing when the context has it, the streamed batch otherwise
+bool g_use_instancing = false;
+ShaderProgram g_instanced_program;
+InstancedSpriteBatch g_instanced_batch;
 glm::mat4 g_view_matrix, g_model_matrix, g_projection_matrix;
 
 float g_previous_ticks = 0.0f;
 float g_time_accumulator = 0.0f;
-const int FONTBANK_SIZE = 16;
 
-GLuint font_texture_id;
+// every image the game draws, packed together at startup
+TextureAtlas g_atlas;
+AtlasRegion g_font;
+
+// --compact-textures lets atlas pages go down to 16 bits a texel, for running lots
+// of instances on one host. --mipmaps gives them mip chains, so the sprites (drawn
+// a lot smaller than their images) don't shimmer. a pack is baked with whichever
+// of the two are given, and only used by runs that give the same ones
+bool g_compact_textures = false;
+bool g_mipmaps = false;
+
+// one reference per thing drawn: each file is decoded once however many sprites use it
+TextureCache g_textures;
+TextureHandle g_player_texture = NO_TEXTURE,
+              g_font_texture   = NO_TEXTURE;
+std::vector<TextureHandle> g_level_textures; // one per level sprite, in sprite order
+AssetPack g_asset_pack;
+
+// --bake-assets FILE writes the asset pack and quits without opening a window
+const char* g_bake_filepath = NULL;
+
+// the HUD, laid out once and only relaid out when its text changes. a
+// TextCommand names its run by index into g_text_runs
+// perfect spacing for the messages (after playing w the spacing and viewport size 1309298 times :p
+enum hud_text { SUCCESS_TEXT, FAILURE_TEXT, TIMER_TEXT };
+TextRun g_success_text(0.6f, -0.2f, glm::vec3(-3.5f, -1.0f, 0.0f)),
+        g_failure_text(0.6f, -0.2f, glm::vec3(-3.0f, -1.0f, 0.0f)),
+        g_timer_text  (0.4f, -0.2f, glm::vec3(-4.4f, 3.5f, 0.0f));
+TextRun* g_text_runs[] = { &g_success_text, &g_failure_text, &g_timer_text };
+char     g_timer_buffer[TextCommand::MAX_LENGTH];
+
+// ————— HEADLESS ————— //
+// --headless draws into an offscreen target instead of a window, on SDL's
+// offscreen video driver (EGL, so a software GL like llvmpipe works on a host
+// with no display). every frame is exactly one physics step, so a run renders
+// the same frames every time, and it quits after --frames frames.
+// --size WxH sets the frame size, --capture DIR writes every frame there as a PPM
+bool g_headless = false;
+int g_headless_frames = 600;
+int g_frames_built = 0;
+int g_frame_width = WINDOW_WIDTH,
+    g_frame_height = WINDOW_HEIGHT;
+const char* g_capture_directory = NULL;
+OffscreenTarget g_offscreen;
+
+// reused for every captured frame
+std::vector<unsigned char> g_capture_rows;
+char g_capture_path[512];
 
 // ———— GENERAL FUNCTIONS ———— //
 
-// purpose: draw text on the screen for UI messages
-void DrawText(ShaderProgram *program, GLuint font_texture_id, std::string text, float screen_size, float spacing, glm::vec3 position)
+// purpose: pick up the headless, texture and baking options, anything else is ignored.
+//          false if an option's value makes no sense
+bool parse_arguments(int argc, char* argv[])
 {
-    // Scale the size of the fontbank in the UV-plane
-    // We will use this for spacing and positioning
-    float width = 1.0f / FONTBANK_SIZE;
-    float height = 1.0f / FONTBANK_SIZE;
-
-    // Instead of having a single pair of arrays, we'll have a series of pairs—one for each character
-    // Don't forget to include <vector>!
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
-
-    // For every character...
-    for (int i = 0; i < text.size(); i++) {
-        // 1. Get their index in the spritesheet, as well as their offset (i.e. their position
-        //    relative to the whole sentence)
-        int spritesheet_index = (int) text[i];  // ascii value of character
-        float offset = (screen_size + spacing) * i;
-        
-        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
-        float u_coordinate = (float) (spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-        float v_coordinate = (float) (spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
-
-        // 3. Inset the current pair in both vectors
-        vertices.insert(vertices.end(), {
-            offset + (-0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-        });
-
-        texture_coordinates.insert(texture_coordinates.end(), {
-            u_coordinate, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate + width, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate, v_coordinate + height,
-        });
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) g_headless = true;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) g_headless_frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) g_capture_directory = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &g_frame_width, &g_frame_height) != 2 || g_frame_width <= 0 || g_frame_height <= 0)
+            {
+                LOG("--size wants a frame size like 640x480.");
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--bake-assets") == 0 && i + 1 < argc) g_bake_filepath = argv[++i];
+        else if (strcmp(argv[i], "--compact-textures") == 0) g_compact_textures = true;
+        else if (strcmp(argv[i], "--mipmaps") == 0) g_mipmaps = true;
     }
-
-    // 4. And render all of them using the pairs
-    glm::mat4 g_model_matrix = glm::mat4(1.0f);
-    g_model_matrix = glm::translate(g_model_matrix, position);
-    
-    g_shader_program.set_model_matrix(g_model_matrix);
-    glUseProgram(g_shader_program.get_program_id());
-    
-    glVertexAttribPointer(g_shader_program.get_position_attribute(), 2, GL_FLOAT, false, 0, vertices.data());
-    glEnableVertexAttribArray(g_shader_program.get_position_attribute());
-    glVertexAttribPointer(g_shader_program.get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, texture_coordinates.data());
-    glEnableVertexAttribArray(g_shader_program.get_tex_coordinate_attribute());
-    
-    glBindTexture(GL_TEXTURE_2D, font_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, (int) (text.size() * 6));
-    
-    glDisableVertexAttribArray(g_shader_program.get_position_attribute());
-    glDisableVertexAttribArray(g_shader_program.get_tex_coordinate_attribute());
+    return true;
 }
 
-// purpose: load texture to sprite
-GLuint load_texture(const char* filepath)
+// purpose: the offscreen target's sink: write a frame as a binary PPM, top row first
+void write_frame(const unsigned char* pixels, int width, int height, unsigned int frame)
 {
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+    if (g_capture_directory == NULL) return;
 
-    if (image == NULL)
+    snprintf(g_capture_path, sizeof(g_capture_path), "%s/frame_%05u.ppm", g_capture_directory, frame);
+    FILE* file = fopen(g_capture_path, "wb");
+    if (file == NULL)
     {
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
+        LOG("Unable to write frame. Make sure the capture directory exists.");
+        return;
     }
 
-    GLuint textureID;
-    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    stbi_image_free(image);
+    // GL hands the rows over bottom first and with alpha, PPM wants neither
+    g_capture_rows.resize(width * height * 3);
+    for (int y = 0; y < height; y++) {
+        const unsigned char* source = pixels + (height - 1 - y) * width * 4;
+        unsigned char* destination  = &g_capture_rows[y * width * 3];
+        for (int x = 0; x < width; x++) {
+            destination[x * 3 + 0] = source[x * 4 + 0];
+            destination[x * 3 + 1] = source[x * 4 + 1];
+            destination[x * 3 + 2] = source[x * 4 + 2];
+        }
+    }
 
-    return textureID;
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    fwrite(g_capture_rows.data(), 1, g_capture_rows.size(), file);
+    fclose(file);
 }
 
 void initialise()
 {
+    // ————— LEVEL ————— //
+    initialise_state(g_game_state);
+    snapshot(g_game_state, g_previous_state);
+
+    // ————— TEXTURES ————— //
+    // the sprites and the font all go in one atlas, so sprites whose images share a
+    // page share a texture and a batch. the font, being greyscale, gets a smaller page
+    // of its own, and so does an image too big for a page (fire.png).
+    // every sprite takes its own reference, the cache decodes each file once. the
+    // level and its references come first so the files decode on worker threads
+    // while the window and context are brought up
+    g_atlas.set_reduced_precision(g_compact_textures);
+    g_atlas.set_mip_levels(g_mipmaps ? MIP_LEVELS : 0);
+    g_textures.initialise(&g_atlas);
+    if (g_asset_pack.open(ASSET_PACK_FILEPATH)) {
+        // its pages go up as they were encoded, so they have to be what this run would make
+        if (g_asset_pack.get_mip_levels() != g_atlas.get_mip_levels() || g_asset_pack.is_reduced_precision() != g_compact_textures) {
+            LOG("Ignoring asset pack " << ASSET_PACK_FILEPATH << ", it was baked with other texture options.");
+            g_asset_pack.close();
+        }
+        else g_textures.use_pack(g_asset_pack);
+    }
+    g_player_texture = g_textures.acquire(SPRITESHEET_FILEPATH);
+
+    Registry& level = g_game_state.level;
+    for (int i = 0; i < level.sprites.size(); i++) {
+        type_of_entity type = level.boxes.get(level.sprites.entity(i)).type;
+        g_level_textures.push_back(g_textures.acquire(type == GOODPLATFORM ? GOOD_PLATFORM_FILEPATH : BAD_PLATFORM_FILEPATH));
+    }
+
+    g_font_texture = g_textures.acquire(FONT_FILEPATH);
+
+    // ————— WINDOW ————— //
+    // without a display, SDL's offscreen driver still makes a (never shown) window and an
+    // EGL context for it. an SDL_VIDEODRIVER set by the user wins
+    if (g_headless) SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+
     SDL_Init(SDL_INIT_VIDEO);
     g_display_window = SDL_CreateWindow("Butterfly lander",
                                         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
                                         WINDOW_WIDTH, WINDOW_HEIGHT,
-                                        SDL_WINDOW_OPENGL);
+                                        g_headless ? SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN : SDL_WINDOW_OPENGL);
     
-    SDL_GLContext context = SDL_GL_CreateContext(g_display_window);
-    SDL_GL_MakeCurrent(g_display_window, context);
+    g_context = SDL_GL_CreateContext(g_display_window);
+    SDL_GL_MakeCurrent(g_display_window, g_context);
     
 #ifdef _WINDOWS
     glewInit();
 #endif
     
-    glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    if (g_headless) {
+        if (!OffscreenTarget::is_supported())
+        {
+            LOG("Headless mode needs framebuffer objects, pixel buffer objects and fences.");
+            assert(false);
+        }
+        g_offscreen.initialise(g_frame_width, g_frame_height, write_frame);
+        g_offscreen.bind();
+        glViewport(0, 0, g_frame_width, g_frame_height);
+    }
+    else glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
     
     g_shader_program.load(V_SHADER_PATH, F_SHADER_PATH);
     
     g_view_matrix = glm::mat4(1.0f);
-    g_projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
+    float half_width = VIEW_HALF_WIDTH;
+    if (g_headless) half_width = VIEW_HALF_HEIGHT * g_frame_width / g_frame_height;
+    g_projection_matrix = glm::ortho(-half_width, half_width, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
     g_model_matrix = glm::mat4(1.0f);
     
-    font_texture_id = load_texture(FONT_FILEPATH);
-    
     g_shader_program.set_projection_matrix(g_projection_matrix);
     g_shader_program.set_view_matrix(g_view_matrix);
-    glUseProgram(g_shader_program.get_program_id());
+    g_shader_program.use();
 
     glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
     
-    // ————— PLAYER ————— //
-    
-    // creating a new player, setting the position, movement, acceleration, and speed
-    g_game_state.player = new Entity();
-    
-    // initialize player on the top right like lunar lander
-    g_game_state.player->set_position(glm::vec3(-3.0f, 3.0f, 0.0f));
-    g_game_state.player->set_movement(glm::vec3(0.0f));
-    g_game_state.player->set_acceleration(glm::vec3(0.0f, ACC_OF_GRAVITY * 0.01, 0.0f));
-    g_game_state.player->set_speed(1.0f);
-    g_game_state.player->m_texture_id = load_texture(SPRITESHEET_FILEPATH);
-    
-    // for collision measurements
-    g_game_state.player->set_height(0.0f);
-    g_game_state.player->set_width(0.4f);
-    
-    
-    // ————— PLATFORM ————— //
-    g_game_state.bad_platform = new Entity[BAD_PLATFORM_COUNT];
-    g_game_state.good_platform = new Entity[GOOD_PLATFORM_COUNT];
-    
-    // Walls
-    g_game_state.wall = new Entity[WALL_COUNT];
-    
-    // for each platform, load texture, set the position, update it, and declare its type
-    for (int i=0; i< GOOD_PLATFORM_COUNT; i++){
-        g_game_state.good_platform[i].m_texture_id = load_texture(GOOD_PLATFORM_FILEPATH);
-        
-        if (i == 0){
-            g_game_state.good_platform[0].set_position(glm::vec3(3.5f, 1.0f, 0.0f));
-        }
-        else{
-            g_game_state.good_platform[1].set_position(glm::vec3(4.0f, 1.0f, 0.0f));
-        }
-        g_game_state.good_platform[i].update(0.0f, NULL, 0);
-        g_game_state.good_platform[i].entity_type = GOODPLATFORM;
+    g_stream_buffer.initialise(STREAM_BUFFER_SIZE);
+    g_sprite_batch.initialise(&g_stream_buffer);
+    g_static_layer.initialise();
+
+    g_use_instancing = InstancedSpriteBatch::is_supported();
+    if (g_use_instancing) {
+        g_instanced_program.load(V_INSTANCED_SHADER_PATH, F_SHADER_PATH);
+        g_instanced_program.set_projection_matrix(g_projection_matrix);
+        g_instanced_program.set_view_matrix(g_view_matrix);
+        g_instanced_batch.initialise(&g_instanced_program, &g_stream_buffer);
+        g_shader_program.use();
     }
-    
-    for (int i = 0; i< BAD_PLATFORM_COUNT; i++){
-        g_game_state.bad_platform[i].m_texture_id = load_texture(BAD_PLATFORM_FILEPATH);
-        
-        if (i == 0){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-2.5f, -3.0f, 0.0f));
-        }
-        else if (i == 1){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-2.7f, -3.0f, 0.0f));
-        }
-        else if (i == 2){
-            g_game_state.bad_platform[i].set_position(glm::vec3(1.5f, 0.0f, 0.0f));
-        }
-        else if (i == 3){
-            g_game_state.bad_platform[i].set_position(glm::vec3(1.3f, 0.0f, 0.0f));
-        }
-        else if (i == 4){
-            g_game_state.bad_platform[i].set_position(glm::vec3(3.0f, -2.0f, 0.0f));
-        }
-        else if (i == 5){
-            g_game_state.bad_platform[i].set_position(glm::vec3(2.8f, -2.0f, 0.0f));
-        }
-        else if (i == 6){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-1.5f, 0.5f, 0.0f));
-        }
-        else if (i == 7){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-1.3f, 0.5f, 0.0f));
-        }
-        else if (i == 8){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-4.2f, -1.0f, 0.0f));
-        }
-        else if (i == 9){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-4.4f, -1.0f, 0.0f));
-        }
-        else if (i == 10){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-4.6f, -1.0f, 0.0f));
-        }
-        else if (i == 11){
-            g_game_state.bad_platform[i].set_position(glm::vec3(0.0f, 2.9f, 0.0f));
-        }
-        else if (i == 12){
-            g_game_state.bad_platform[i].set_position(glm::vec3(0.2f, 2.9f, 0.0f));
-        }
-        else if (i == 13){
-            g_game_state.bad_platform[i].set_position(glm::vec3(0.4f, 2.9f, 0.0f));
-        }
-        else if (i == 14){
-            g_game_state.bad_platform[i].set_position(glm::vec3(-2.9f, -3.0f, 0.0f));
-        }
-        else if (i == 15){
-            g_game_state.bad_platform[i].set_position(glm::vec3(2.5f, -2.0f, 0.0f));
-        }
-        else{
-            g_game_state.bad_platform[i].set_position(glm::vec3(-1.7f, 0.5f, 0.0f));
-        }
-        g_game_state.bad_platform[i].update(0.0f, NULL, 0);
-        g_game_state.bad_platform[i].entity_type = BADPLATFORM;
-    }
-    
-    font_texture_id = load_texture(FONT_FILEPATH);
-    
-    g_game_state.player->entity_type = PLAYER;
-    
-    // setting the position and measurements for walls
-    g_game_state.wall[0].set_position(glm::vec3(-6.0f, 0.0f, 0.0f));
-    g_game_state.wall[1].set_position(glm::vec3(6.0f, 0.0f, 0.0f));
-    g_game_state.wall[2].set_position(glm::vec3(0.0f, 4.5f, 0.0f));
-    g_game_state.wall[3].set_position(glm::vec3(0.0f, -4.5f, 0.0f));
-    
-    // left and right walls: 
-        // width-> 0.1, height-> viewport height
-    
-    // top and bottom walls:
-        // width-> viewport height , height-> 0.1
-    g_game_state.wall[0].set_width(0.1f);
-    g_game_state.wall[1].set_width(0.1f);
-    g_game_state.wall[2].set_height(0.1f);
-    g_game_state.wall[3].set_height(0.1f);
-
-    g_game_state.wall[2].set_width(VIEWPORT_WIDTH);
-    g_game_state.wall[3].set_width(VIEWPORT_WIDTH);
-    g_game_state.wall[0].set_height(VIEWPORT_HEIGHT);
-    g_game_state.wall[1].set_height(VIEWPORT_HEIGHT);
-    
-    for (int i=0; i< WALL_COUNT; i++){
-        g_game_state.wall[i].entity_type = WALLS;
+
+    // ————— TEXTURES ————— //
+    // every image has to be in the atlas before anything can say where it is
+    g_textures.drain();
+    g_asset_pack.close(); // its pages are on the GPU now
+
+    // the simulation doesn't know about textures, so hand them out here
+    AtlasRegion player = g_textures.get_region(g_player_texture);
+    g_game_state.lander.player.m_texture_id = player.texture_id;
+    g_game_state.lander.player.m_uv_rect    = player.uv_rect;
+
+    // the butterfly flaps: its frames are cells of one sheet in the atlas
+    Animation const& flapping = g_textures.get_animation(g_player_texture);
+    g_game_state.lander.player.m_animation_frames     = flapping.frame_count;
+    g_game_state.lander.player.m_animation_cols       = flapping.columns;
+    g_game_state.lander.player.m_animation_rows       = flapping.rows;
+    g_game_state.lander.player.m_animation_delays     = flapping.delays.empty() ? NULL : flapping.delays.data();
+    g_game_state.lander.player.m_animation_frame_rect = flapping.frame_rect;
+
+    for (int i = 0; i < level.sprites.size(); i++) {
+        AtlasRegion platform = g_textures.get_region(g_level_textures[i]);
+        level.sprites[i].texture_id = platform.texture_id;
+        level.sprites[i].uv_rect    = platform.uv_rect;
     }
-    g_game_state.good_platform->entity_type = GOODPLATFORM;
-    
+
+    g_font = g_textures.get_region(g_font_texture);
+
+    // ————— HUD ————— //
+    for (TextRun* run : g_text_runs) run->initialise(g_font, &g_stream_buffer);
+
+    g_static_layer.begin();
+    render_sprites(g_static_layer, level);
+    g_static_layer.upload(GL_STATIC_DRAW);
+
     // ————— GENERAL ————— //
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glEnable(GL_BLEND);
@@ -352,9 +372,6 @@ void initialise()
 
 void process_input()
 {
-    // VERY IMPORTANT: If nothing is pressed, we don't want to go anywhere
-    g_game_state.player->set_movement(glm::vec3(0.0f));
-
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
@@ -365,6 +382,10 @@ void process_input()
             g_game_is_running = false;
             break;
 
+        case SDL_WINDOWEVENT:
+            if (event.window.event == SDL_WINDOWEVENT_EXPOSED) g_redraw = true;
+            break;
+
         case SDL_KEYDOWN:
             switch (event.key.keysym.sym) {
             case SDLK_q:
@@ -381,43 +402,27 @@ void process_input()
         }
     }
 
+    // the simulation applies these to the player on every step
     const Uint8* key_state = SDL_GetKeyboardState(NULL);
 
-    // move left, if its not pressed, set x acceleration to 0
-    if (key_state[SDL_SCANCODE_LEFT])
-    {
-        g_game_state.player->move_left();
-    }
-    else {
-        g_game_state.player->set_acceleration_x(0.0f);
-    }
-    
-    if (key_state[SDL_SCANCODE_RIGHT])
-    {
-        g_game_state.player->move_right();
-    }
-    
-    // move up, if its not pressed, set y acceleration to the acc_of_gravity to keep it falling
-    if (key_state[SDL_SCANCODE_UP]){
-        g_game_state.player->move_up();
-    }
-    else{
-        g_game_state.player->set_acceleration_y(ACC_OF_GRAVITY);
-    }
-
-    // This makes sure that the player can't move faster diagonally
-    if (glm::length(g_game_state.player->get_movement()) > 1.0f)
-    {
-        g_game_state.player->set_movement(glm::normalize(g_game_state.player->get_movement()));
-    }
+    g_input.left  = key_state[SDL_SCANCODE_LEFT];
+    g_input.right = key_state[SDL_SCANCODE_RIGHT];
+    g_input.up    = key_state[SDL_SCANCODE_UP];
 }
 
 void update()
 {
     // delta time stuff
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
-    float delta_time = ticks - g_previous_ticks;
-    g_previous_ticks = ticks;
+    float delta_time = FIXED_TIMESTEP;
+    if (!g_headless) {
+        float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
+        delta_time = ticks - g_previous_ticks;
+        g_previous_ticks = ticks;
+    }
+
+    // flap at the gif's own pace, whatever the physics rate. once it has landed it
+    // stays still, so a finished run has nothing left to redraw
+    if (!is_finished(g_game_state)) g_game_state.lander.player.animate(delta_time);
 
     // fixed timestep stuff
     delta_time += g_time_accumulator;
@@ -427,71 +432,197 @@ void update()
         g_time_accumulator = delta_time;
         return;
     }
-    if (g_timer_running) {
-            g_timer_value += FIXED_TIMESTEP;
-        }
-    
-    while (delta_time >= FIXED_TIMESTEP)
+
+    int steps = 0;
+    while (delta_time >= FIXED_TIMESTEP && steps < MAX_STEPS_PER_FRAME)
     {
-        // updating platforms based on time
-        g_game_state.player->update(FIXED_TIMESTEP, g_game_state.bad_platform, BAD_PLATFORM_COUNT);
-        g_game_state.player->update(FIXED_TIMESTEP, g_game_state.good_platform, GOOD_PLATFORM_COUNT);
-        g_game_state.player->update(FIXED_TIMESTEP, g_game_state.wall, WALL_COUNT);
+        snapshot(g_game_state, g_previous_state);
+        step(g_game_state, g_input, FIXED_TIMESTEP);
         delta_time -= FIXED_TIMESTEP;
+        steps++;
     }
+
+    // still behind after the cap: let the extra time go, but keep the fraction of
+    // a step so rendering stays in phase
+    if (delta_time >= FIXED_TIMESTEP) delta_time = fmodf(delta_time, FIXED_TIMESTEP);
+
     g_time_accumulator = delta_time;
 }
 
-void render()
+// purpose: record this frame for the render thread, runs on the simulation thread
+void build_draw_list(DrawList& list)
 {
-    // ————— GENERAL ————— //
-    glClear(GL_COLOR_BUFFER_BIT);
-    
+    list.clear();
 
-    // player stuff
-    g_game_state.player->render(&g_shader_program);
+    // player stuff, the only sprite that's streamed every frame
+    // draw the player between the last two physics steps, as far along as the
+    // time left in the accumulator, so motion is smooth at any physics rate
+    float alpha = g_time_accumulator / FIXED_TIMESTEP;
+    glm::vec3 drawn_position = glm::mix(g_previous_state.player.get_position(),
+                                        g_game_state.lander.player.get_position(), alpha);
+
+    const Entity& player = g_game_state.lander.player;
+    glm::vec4 frame = player.m_animation_frames > 1 ? player.get_animation_uv_rect(player.m_animation_index) : player.m_uv_rect;
+    list.add_sprite(player.m_texture_id, drawn_position, glm::vec2(1.0f), frame);
 
-    // platform stuff
-    for (int i = 0; i < BAD_PLATFORM_COUNT; i++) {
-            g_game_state.bad_platform[i].render(&g_shader_program);
-    }
-    for (int i = 0; i < GOOD_PLATFORM_COUNT; i++) {
-            g_game_state.good_platform[i].render(&g_shader_program);
-    }
-    
     // if it collides with a good platform, show a winner message
-    if (g_game_state.player->collides == GOODPLATFORM) {
-            DrawText(&g_shader_program, font_texture_id, "MISSION SUCCESSFUL :)", 0.6, -0.2f, glm::vec3(-3.5f, -1.0f, 0.0f));
-            g_timer_running= false;
+    if (g_game_state.lander.player.collides == GOODPLATFORM) {
+            list.add_text(SUCCESS_TEXT, "MISSION SUCCESSFUL :)");
         }
     
     // if it collides with a bad platform or walls, show a loser message
-    else if (g_game_state.player->collides == BADPLATFORM || g_game_state.player->collides == WALLS) {
-        
-            // perfect spacing for the message (after playing w the spacing and viewport size 1309298 times :p
-            DrawText(&g_shader_program, font_texture_id, "MISSION FAILED :(", 0.6, -0.2f, glm::vec3(-3.0f,-1.0f,0.0f));
-            g_timer_running = false;
+    else if (g_game_state.lander.player.collides == BADPLATFORM || g_game_state.lander.player.collides == WALLS) {
+            list.add_text(FAILURE_TEXT, "MISSION FAILED :(");
         }
     
     // drawing the timer output
-    std::string timerText = "TIME: " + std::to_string(g_timer_value);
-    DrawText(&g_shader_program, font_texture_id, timerText, 0.4, -0.2f, glm::vec3(-4.4f, 3.5f, 0.0f));
+    format_number(g_timer_buffer, sizeof(g_timer_buffer), "TIME: ", g_game_state.lander.timer_value);
+    list.add_text(TIMER_TEXT, g_timer_buffer);
+}
+
+// purpose: draw one frame's list, runs on the render thread
+void render(const DrawList& list)
+{
+    // ————— GENERAL ————— //
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (g_use_instancing) {
+        g_instanced_batch.begin();
+        for (SpriteCommand const& sprite : list.sprites)
+            g_instanced_batch.draw(sprite.texture_id, sprite.position, sprite.size, sprite.uv_rect);
+        g_instanced_batch.end(&g_instanced_program);
+    }
+    else {
+        g_sprite_batch.begin();
+        for (SpriteCommand const& sprite : list.sprites)
+            g_sprite_batch.draw(sprite.texture_id, sprite.position, sprite.size, sprite.uv_rect);
+        g_sprite_batch.end(&g_shader_program);
+    }
 
-    SDL_GL_SwapWindow(g_display_window);
+    // platform stuff, already on the GPU
+    g_static_layer.render(&g_shader_program);
+
+    for (TextCommand const& text : list.texts) {
+        TextRun* run = g_text_runs[text.run];
+        run->set_text(text.text);
+        run->render(&g_shader_program);
+    }
+
+    // offscreen there's nothing to swap to, the frame is read back instead
+    if (g_headless) g_offscreen.capture();
+    else            SDL_GL_SwapWindow(g_display_window);
 }
 
-void shutdown() { SDL_Quit(); }
+// purpose: give back every texture reference, the last one frees the atlas (so
+//          this needs the GL context)
+void release_textures()
+{
+    for (TextureHandle handle : g_level_textures) g_textures.release(handle);
+    g_level_textures.clear();
+
+    g_textures.release(g_player_texture);
+    g_textures.release(g_font_texture);
+    g_player_texture = NO_TEXTURE;
+    g_font_texture   = NO_TEXTURE;
+}
+
+// purpose: the render thread: take the newest draw list, draw it, repeat. the GL
+//          resources are freed here too, since this is the thread holding the context
+void render_loop()
+{
+    SDL_GL_MakeCurrent(g_display_window, g_context);
+
+    // swap on vblank, but late swaps go straight out (adaptive sync) where the driver has it
+    if (!g_headless && SDL_GL_SetSwapInterval(-1) != 0) SDL_GL_SetSwapInterval(1);
+
+    while (true)
+    {
+        SDL_SemWait(g_list_ready);
+        if (!g_render_running.load(std::memory_order_acquire)) break;
+
+        if (g_draw_lists.acquire()) render(g_draw_lists.get_front());
+    }
+
+    if (g_headless) g_offscreen.shutdown();
+    g_sprite_batch.shutdown();
+    g_static_layer.shutdown();
+    g_stream_buffer.shutdown();
+    release_textures();
+    if (g_use_instancing) g_instanced_batch.shutdown();
+
+    SDL_GL_MakeCurrent(g_display_window, NULL);
+}
+
+void shutdown()
+{
+    // the render thread frees everything on the GL side before it exits
+    g_render_running.store(false, std::memory_order_release);
+    SDL_SemPost(g_list_ready);
+    g_render_thread.join();
+    SDL_DestroySemaphore(g_list_ready);
+
+    shutdown_state(g_game_state);
+    SDL_GL_DeleteContext(g_context);
+    SDL_Quit();
+}
 
 // driver game loop
 int main(int argc, char* argv[])
 {
+    if (!parse_arguments(argc, argv)) return 1;
+    if (g_bake_filepath != NULL) {
+        int count = sizeof(BAKED_FILEPATHS) / sizeof(BAKED_FILEPATHS[0]);
+        return AssetPack::write(g_bake_filepath, BAKED_FILEPATHS, count, g_mipmaps ? MIP_LEVELS : 0, g_compact_textures) ? 0 : 1;
+    }
+
     initialise();
 
+    // hand the context over to the render thread
+    SDL_GL_MakeCurrent(g_display_window, NULL);
+    g_list_ready = SDL_CreateSemaphore(0);
+    g_render_running.store(true, std::memory_order_release);
+    g_render_thread = std::thread(render_loop);
+
+    SDL_DisplayMode mode;
+    bool known_rate = SDL_GetWindowDisplayMode(g_display_window, &mode) == 0 && mode.refresh_rate > 0;
+    g_pacer.initialise(known_rate ? mode.refresh_rate : DEFAULT_REFRESH_RATE);
+
     while (g_game_is_running)
     {
         process_input();
         update();
-        render();
+
+        DrawList& list = g_draw_lists.get_back();
+        build_draw_list(list);
+
+        // headless runs want every frame, and as fast as they come
+        if (g_headless) {
+            g_draw_lists.publish();
+            SDL_SemPost(g_list_ready);
+            if (++g_frames_built >= g_headless_frames) g_game_is_running = false;
+
+            // simulate the next frame while this one draws, but no further ahead than that
+            while (g_draw_lists.is_pending()) std::this_thread::yield();
+            continue;
+        }
+
+        if (!g_redraw && list.same_as(g_last_list)) {
+            // nothing to draw. if the run is over nothing will be until there's input
+            if (is_finished(g_game_state) && g_game_is_running) {
+                SDL_WaitEvent(NULL);
+                g_pacer.reset();
+            }
+            else g_pacer.wait();
+            continue;
+        }
+
+        // copying into the same list every frame reuses its storage
+        g_last_list = list;
+        g_redraw = false;
+        g_draw_lists.publish();
+        SDL_SemPost(g_list_ready);
+
+        g_pacer.wait();
     }
 
     shutdown();
@@ -0,0 +1,20 @@
+// vertex_textured.glsl for InstancedSpriteBatch: one unit quad, drawn once per
+// instance, placed and textured from per-instance attributes instead of modelMatrix
+attribute vec4 position;
+attribute vec2 texCoord;
+
+attribute vec2 instancePosition; // centre of the sprite
+attribute vec2 instanceScale;    // width, height
+attribute vec4 instanceUV;       // u0, v0, u1, v1 (v0 at the top)
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 texCoordVar;
+
+void main()
+{
+	vec4 p = viewMatrix * vec4(position.xy * instanceScale + instancePosition, 0.0, 1.0);
+    texCoordVar = mix(instanceUV.xy, instanceUV.zw, texCoord);
+	gl_Position = projectionMatrix * p;
+}
@@ -5761,7 +5761,9 @@ static int stbi__gif_header(stbi__context *s, stbi__gif *g, int *comp, int is_in
    if (version != '7' && version != '9')    return stbi__err("not GIF", "Corrupt GIF");
    if (stbi__get8(s) != 'a')                return stbi__err("not GIF", "Corrupt GIF");
 
+#ifndef STBI_NO_FAILURE_STRINGS // lunar lander: this write races when GIFs decode on several threads
    stbi__g_failure_reason = "";
+#endif
    g->w = stbi__get16le(s);
    g->h = stbi__get16le(s);
    g->flags = stbi__get8(s);